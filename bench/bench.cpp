@@ -0,0 +1,261 @@
+#include "../src/lib/Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Macro benchmark runner. Runs every Scrypt program of the suite in-process on
+// each available engine, reports the median and standard deviation of the run
+// time and optionally compares the medians against a stored baseline.
+
+// Stream buffer that drops everything, so print-heavy programs do not measure
+// the terminal
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+struct Result {
+    std::string script;
+    std::string engine;
+    double medianMs = 0;
+    double stddevMs = 0;
+};
+
+struct BaselineEntry {
+    std::string script;
+    std::string engine;
+    double medianMs = 0;
+    double thresholdPct = -1;   // -1 uses the command line threshold
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+    if (samples.size() % 2 == 0) {
+        return (samples[middle - 1] + samples[middle]) / 2;
+    }
+    return samples[middle];
+}
+
+double stddev(const std::vector<double>& samples) {
+    if (samples.size() < 2) {
+        return 0;
+    }
+    double mean = 0;
+    for (double sample : samples) {
+        mean += sample;
+    }
+    mean /= samples.size();
+    double sum = 0;
+    for (double sample : samples) {
+        sum += (sample - mean) * (sample - mean);
+    }
+    return std::sqrt(sum / (samples.size() - 1));
+}
+
+// Value of "key": "..." inside one flat JSON object
+std::string jsonString(const std::string& object, const std::string& key) {
+    size_t pos = object.find("\"" + key + "\"");
+    if (pos == std::string::npos) return "";
+    size_t start = object.find('"', object.find(':', pos) + 1);
+    size_t end = object.find('"', start + 1);
+    return object.substr(start + 1, end - start - 1);
+}
+
+// Value of "key": number inside one flat JSON object, or fallback when missing
+double jsonNumber(const std::string& object, const std::string& key, double fallback) {
+    size_t pos = object.find("\"" + key + "\"");
+    if (pos == std::string::npos) return fallback;
+    return std::stod(object.substr(object.find(':', pos) + 1));
+}
+
+// Reads the "results" array written by --write-baseline
+std::vector<BaselineEntry> readBaseline(const std::string& path) {
+    std::vector<BaselineEntry> entries;
+    std::string text = readFile(path);
+    size_t pos = text.find("\"results\"");
+    if (pos == std::string::npos) {
+        return entries;
+    }
+    while ((pos = text.find('{', pos)) != std::string::npos) {
+        size_t end = text.find('}', pos);
+        std::string object = text.substr(pos, end - pos + 1);
+        BaselineEntry entry;
+        entry.script = jsonString(object, "script");
+        entry.engine = jsonString(object, "engine");
+        entry.medianMs = jsonNumber(object, "medianMs", 0);
+        entry.thresholdPct = jsonNumber(object, "thresholdPct", -1);
+        entries.push_back(entry);
+        pos = end;
+    }
+    return entries;
+}
+
+void writeBaseline(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream file(path);
+    file << std::fixed << std::setprecision(3) << "{\"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        file << (i > 0 ? "," : "") << "\n  {\"script\": \"" << results[i].script << "\", \"engine\": \""
+             << results[i].engine << "\", \"medianMs\": " << results[i].medianMs
+             << ", \"stddevMs\": " << results[i].stddevMs << "}";
+    }
+    file << "\n]}" << std::endl;
+}
+
+void usage() {
+    std::cerr << "usage: bench_runner [--dir=DIR] [--warmup=N] [--reps=N] [--baseline=FILE] "
+                 "[--threshold=PCT] [--write-baseline=FILE] [--json] [script.scr ...]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string dir = "bench";
+    int warmup = 2;
+    int reps = 10;
+    double threshold = 10;
+    std::string baselinePath;
+    std::string writePath;
+    bool json = false;
+    std::vector<std::string> scripts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+        if (arg.rfind("--dir=", 0) == 0) {
+            dir = value();
+        } else if (arg.rfind("--warmup=", 0) == 0) {
+            warmup = std::stoi(value());
+        } else if (arg.rfind("--reps=", 0) == 0) {
+            reps = std::max(1, std::stoi(value()));
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            baselinePath = value();
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::stod(value());
+        } else if (arg.rfind("--write-baseline=", 0) == 0) {
+            writePath = value();
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            usage();
+            return 2;
+        } else {
+            scripts.push_back(arg);
+        }
+    }
+    if (scripts.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (entry.path().extension() == ".scr") {
+                scripts.push_back(entry.path().string());
+            }
+        }
+        std::sort(scripts.begin(), scripts.end());
+    }
+    if (scripts.empty()) {
+        std::cerr << "No benchmark scripts found in " << dir << std::endl;
+        return 2;
+    }
+
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    std::vector<Result> results;
+    bool failed = false;
+
+    for (const auto& path : scripts) {
+        std::string source = readFile(path);
+        std::string script = std::filesystem::path(path).filename().string();
+        for (const auto& engine : engines()) {
+            int exitCode = 0;
+            for (int i = 0; i < warmup; ++i) {
+                exitCode = engine.run(source, nullStream);
+            }
+            std::vector<double> samples;
+            for (int i = 0; i < reps; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                exitCode = engine.run(source, nullStream);
+                samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+            if (exitCode != 0) {
+                std::cerr << script << " on " << engine.name << " exited with " << exitCode << std::endl;
+                failed = true;
+            }
+            results.push_back({script, engine.name, median(samples), stddev(samples)});
+        }
+    }
+
+    std::vector<BaselineEntry> baseline;
+    if (!baselinePath.empty()) {
+        baseline = readBaseline(baselinePath);
+    }
+    auto findBaseline = [&baseline](const Result& result) -> const BaselineEntry* {
+        for (const auto& entry : baseline) {
+            if (entry.script == result.script && entry.engine == result.engine) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    };
+
+    if (json) {
+        std::cout << std::fixed << std::setprecision(3) << "{\"results\": [";
+    } else {
+        std::cout << std::left << std::setw(28) << "script" << std::setw(14) << "engine" << std::right
+                  << std::setw(12) << "median ms" << std::setw(12) << "stddev ms";
+        if (!baseline.empty()) {
+            std::cout << std::setw(12) << "baseline" << std::setw(10) << "change" << "  status";
+        }
+        std::cout << std::endl << std::fixed << std::setprecision(3);
+    }
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        const BaselineEntry* entry = findBaseline(result);
+        double change = 0;
+        std::string status;
+        if (entry && entry->medianMs > 0) {
+            double limit = entry->thresholdPct >= 0 ? entry->thresholdPct : threshold;
+            change = (result.medianMs - entry->medianMs) / entry->medianMs * 100;
+            status = change > limit ? "REGRESSION" : "ok";
+            if (change > limit) {
+                failed = true;
+            }
+        }
+        if (json) {
+            std::cout << (i > 0 ? "," : "") << "\n  {\"script\": \"" << result.script << "\", \"engine\": \""
+                      << result.engine << "\", \"medianMs\": " << result.medianMs << ", \"stddevMs\": " << result.stddevMs;
+            if (entry) {
+                std::cout << ", \"baselineMs\": " << entry->medianMs << ", \"changePct\": " << change
+                          << ", \"status\": \"" << status << "\"";
+            }
+            std::cout << "}";
+            continue;
+        }
+        std::cout << std::left << std::setw(28) << result.script << std::setw(14) << result.engine << std::right
+                  << std::setw(12) << result.medianMs << std::setw(12) << result.stddevMs;
+        if (entry) {
+            std::cout << std::setw(12) << entry->medianMs << std::setw(9) << std::showpos << change
+                      << std::noshowpos << "%  " << status;
+        }
+        std::cout << std::endl;
+    }
+    if (json) {
+        std::cout << "\n]}" << std::endl;
+    }
+
+    if (!writePath.empty()) {
+        writeBaseline(writePath, results);
+    }
+    return failed ? 1 : 0;
+}
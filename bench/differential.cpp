@@ -0,0 +1,212 @@
+#include "../src/lib/Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Differential engine matrix. Runs every Scrypt program of the given corpus
+// directories on each engine in engines(), checks that stdout and the exit code
+// match the first (reference) engine byte for byte, and prints a speed table
+// with one column per engine.
+// A program with a .expected file next to it (bench/checks) is also checked
+// against that file: the reference engine's output, followed by a last line
+// "exit N" with its exit code.
+
+struct Run {
+    std::string output;
+    int exitCode = 0;
+    double medianMs = 0;
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// Reads the expected run of script.scr from script.expected, if there is one
+bool readExpected(const std::string& scriptPath, Run& expected) {
+    std::filesystem::path path(scriptPath);
+    path.replace_extension(".expected");
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    std::string text = readFile(path.string());
+    size_t lastLine = text.rfind("exit ", text.size() < 5 ? 0 : text.size() - 5);
+    if (lastLine == std::string::npos || (lastLine > 0 && text[lastLine - 1] != '\n')) {
+        throw std::runtime_error(path.string() + ": missing last line \"exit N\"");
+    }
+    expected.output = text.substr(0, lastLine);
+    expected.exitCode = std::stoi(text.substr(lastLine + 5));
+    return true;
+}
+
+Run runEngine(const Engine& engine, const std::string& source, int reps) {
+    Run run;
+    std::vector<double> samples;
+    for (int i = 0; i < reps; ++i) {
+        std::ostringstream out;
+        auto start = std::chrono::steady_clock::now();
+        run.exitCode = engine.run(source, out);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        run.output = out.str();
+    }
+    std::sort(samples.begin(), samples.end());
+    run.medianMs = samples[samples.size() / 2];
+    return run;
+}
+
+// Describes the first difference between the reference and another run
+std::string describeMismatch(const Run& reference, const Run& other) {
+    std::ostringstream message;
+    if (reference.exitCode != other.exitCode) {
+        message << "exit code " << other.exitCode << ", expected " << reference.exitCode;
+        if (reference.output == other.output) {
+            return message.str();
+        }
+        message << "; ";
+    }
+    size_t offset = 0;
+    while (offset < reference.output.size() && offset < other.output.size() &&
+           reference.output[offset] == other.output[offset]) {
+        ++offset;
+    }
+    int line = 1 + static_cast<int>(std::count(reference.output.begin(), reference.output.begin() + offset, '\n'));
+    auto lineAt = [offset](const std::string& text) {
+        size_t start = text.rfind('\n', offset == 0 ? 0 : offset - 1);
+        start = (start == std::string::npos || offset == 0) ? 0 : start + 1;
+        size_t end = text.find('\n', start);
+        return text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    };
+    message << "output differs at byte " << offset << " (line " << line << "): got \"" << lineAt(other.output)
+            << "\", expected \"" << lineAt(reference.output) << "\"";
+    return message.str();
+}
+
+void usage() {
+    std::cerr << "usage: differential [--reps=N] [--json] [DIR|script.scr ...]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int reps = 3;
+    bool json = false;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--reps=", 0) == 0) {
+            reps = std::max(1, std::stoi(arg.substr(7)));
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            usage();
+            return 2;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        inputs = {"bench", "bench/fuzz", "bench/checks"};
+    }
+
+    std::vector<std::string> scripts;
+    for (const std::string& input : inputs) {
+        if (!std::filesystem::is_directory(input)) {
+            scripts.push_back(input);
+            continue;
+        }
+        std::vector<std::string> found;
+        for (const auto& entry : std::filesystem::directory_iterator(input)) {
+            if (entry.path().extension() == ".scr") {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        scripts.insert(scripts.end(), found.begin(), found.end());
+    }
+    if (scripts.empty()) {
+        std::cerr << "No Scrypt programs found" << std::endl;
+        return 2;
+    }
+
+    const std::vector<Engine>& all = engines();
+    int mismatches = 0;
+
+    if (json) {
+        std::cout << std::fixed << std::setprecision(3) << "{\"engines\": [";
+        for (size_t e = 0; e < all.size(); ++e) {
+            std::cout << (e > 0 ? ", " : "") << "\"" << all[e].name << "\"";
+        }
+        std::cout << "], \"results\": [";
+    } else {
+        std::cout << std::left << std::setw(36) << "script" << std::right << std::setw(6) << "exit";
+        for (const Engine& engine : all) {
+            std::cout << std::setw(16) << (std::string(engine.name) + " ms");
+        }
+        std::cout << "  status" << std::endl << std::fixed << std::setprecision(3);
+    }
+
+    for (size_t s = 0; s < scripts.size(); ++s) {
+        const std::string& path = scripts[s];
+        std::string source = readFile(path);
+        std::vector<Run> runs;
+        std::vector<std::string> problems;
+        Run expected;
+        bool hasExpected = false;
+        try {
+            hasExpected = readExpected(path, expected);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 2;
+        }
+        for (const Engine& engine : all) {
+            runs.push_back(runEngine(engine, source, reps));
+            const Run& run = runs.back();
+            if (runs.size() > 1 && (run.exitCode != runs[0].exitCode || run.output != runs[0].output)) {
+                problems.push_back(std::string(engine.name) + ": " + describeMismatch(runs[0], run));
+            }
+        }
+        if (hasExpected && (runs[0].exitCode != expected.exitCode || runs[0].output != expected.output)) {
+            problems.push_back(std::string(all[0].name) + ": " + describeMismatch(expected, runs[0]));
+        }
+        mismatches += static_cast<int>(problems.size());
+
+        if (json) {
+            std::cout << (s > 0 ? "," : "") << "\n  {\"script\": \"" << path << "\", \"exitCode\": " << runs[0].exitCode
+                      << ", \"match\": " << (problems.empty() ? "true" : "false") << ", \"ms\": {";
+            for (size_t e = 0; e < all.size(); ++e) {
+                std::cout << (e > 0 ? ", " : "") << "\"" << all[e].name << "\": " << runs[e].medianMs;
+            }
+            std::cout << "}}";
+            continue;
+        }
+        std::cout << std::left << std::setw(36) << path << std::right << std::setw(6) << runs[0].exitCode;
+        for (size_t e = 0; e < all.size(); ++e) {
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(3) << runs[e].medianMs;
+            if (e > 0 && runs[e].medianMs > 0) {
+                cell << " (" << std::setprecision(1) << runs[0].medianMs / runs[e].medianMs << "x)";
+            }
+            std::cout << std::setw(16) << cell.str();
+        }
+        std::cout << "  " << (problems.empty() ? "ok" : "MISMATCH") << std::endl;
+        for (const std::string& problem : problems) {
+            std::cout << "    " << problem << std::endl;
+        }
+    }
+
+    if (json) {
+        std::cout << "\n]}" << std::endl;
+    } else {
+        std::cout << scripts.size() << " programs, " << all.size() << " engine" << (all.size() == 1 ? "" : "s")
+                  << ", " << mismatches << " mismatch" << (mismatches == 1 ? "" : "es") << std::endl;
+    }
+    return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,312 @@
+#include "../src/lib/lex.h"
+#include "../src/lib/Stats.h"
+#ifdef SEXPR_PARSER
+#include "../src/lib/parse.h"
+#else
+#include "../src/lib/mParser.h"
+#include "../src/lib/infixParser.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Front-end microbenchmarks. Generates synthetic inputs of a given size and
+// shape, then times the lexer and each parser on them separately and reports
+// throughput and allocations. Every shape is run at three sizes so that
+// superlinear behaviour shows up as a scaling exponent above 1.
+//
+// The S-expression parser declares Parser and Node like mParser and the infix
+// parser do, so it is measured by a second build of this file with
+// -DSEXPR_PARSER.
+
+enum class Dialect { Scrypt, Infix, SExpr };
+
+struct Sample {
+    double ms = 0;
+    uint64_t allocations = 0;
+    size_t tokens = 0;
+    size_t nodes = 0;
+    bool ok = true;
+};
+
+struct Row {
+    std::string frontend;
+    std::string shape;
+    size_t bytes = 0;
+    Sample sample;
+};
+
+// Infix expression nested depth levels deep, e.g. ((1 + 2) * 3)
+std::string nestedInfix(int depth, int seed) {
+    std::string text = std::to_string(seed % 10);
+    for (int level = 1; level <= depth; ++level) {
+        text = "(" + text + (level % 2 ? " + " : " * ") + std::to_string((seed + level) % 10) + ")";
+    }
+    return text;
+}
+
+std::string nestedSExpr(int depth, int seed) {
+    std::string text = std::to_string(seed % 10);
+    for (int level = 1; level <= depth; ++level) {
+        text = std::string(level % 2 ? "(+ " : "(* ") + text + " " + std::to_string((seed + level) % 10) + ")";
+    }
+    return text;
+}
+
+// Builds roughly bytes characters of the given shape. Scrypt inputs are
+// programs of small statements; infix and S-expression inputs are a single
+// expression, because those parsers accept exactly one per input.
+std::string generate(Dialect dialect, const std::string& shape, size_t bytes, int depth) {
+    std::string text;
+    for (int i = 0; text.size() < bytes; ++i) {
+        std::string a = "alpha" + std::to_string(i % 97);
+        std::string b = "beta" + std::to_string(i % 89);
+        std::string x = std::to_string(i % 1000) + "." + std::to_string(i % 7);
+        std::string y = std::to_string(i % 31);
+        if (dialect == Dialect::Scrypt) {
+            if (shape == "identifiers") {
+                text += "value" + std::to_string(i % 50) + " = " + a + " + " + b + " * gamma" + std::to_string(i % 13) + ";\n";
+            } else if (shape == "numbers") {
+                text += "x = " + x + " + " + y + " * 7.25 - 1024;\n";
+            } else if (shape == "nested") {
+                text += "x = " + nestedInfix(depth, i) + ";\n";
+            } else {
+                text += "def f" + std::to_string(i) + "(a, b) {\n    c = a + b;\n    if c > 10 {\n        return c * 2;\n    }\n    return c;\n}\n";
+            }
+        } else if (dialect == Dialect::Infix) {
+            std::string term = shape == "identifiers" ? a + " + " + b + " * gamma" + std::to_string(i % 13)
+                             : shape == "numbers" ? x + " + " + y + " * 7.25"
+                             : nestedInfix(depth, i);
+            text += (i > 0 ? " + " : "") + term;
+        } else {
+            std::string term = shape == "identifiers" ? "(* " + a + " " + b + ")"
+                             : shape == "numbers" ? "(* " + x + " " + y + ")"
+                             : nestedSExpr(depth, i);
+            text += (i > 0 ? " " : "(+ ") + term;
+        }
+    }
+    if (dialect == Dialect::SExpr) {
+        text += ")";
+    }
+    return text + "\n";
+}
+
+#ifndef SEXPR_PARSER
+size_t countInfixNodes(const Node* node) {
+    if (!node) return 0;
+    size_t count = 1;
+    for (const Node* child : node->children) {
+        count += countInfixNodes(child);
+    }
+    return count;
+}
+#else
+size_t countSExprNodes(const Node* node) {
+    if (!node) return 0;
+    size_t count = 1;
+    for (const Node* child : node->children) {
+        count += countSExprNodes(child);
+    }
+    return count;
+}
+#endif
+
+// Median of reps runs of measure; each run fills in its own time and counts
+Sample measure(int reps, const std::function<Sample()>& run) {
+    std::vector<Sample> samples;
+    for (int i = 0; i < reps; ++i) {
+        samples.push_back(run());
+        if (!samples.back().ok) {
+            return samples.back();
+        }
+    }
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.ms < b.ms; });
+    return samples[samples.size() / 2];
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+Sample lexOnce(const std::string& source) {
+    Sample sample;
+    uint64_t allocations = allocationCount();
+    auto start = std::chrono::steady_clock::now();
+    Lexer lexer(source);
+    std::vector<Token> tokens = lexer.tokenize();
+    sample.ms = elapsedMs(start);
+    sample.allocations = allocationCount() - allocations;
+    sample.tokens = tokens.size();
+    return sample;
+}
+
+// Times parse() only; the tokens are produced beforehand and the tree is
+// freed after the clock stops
+Sample parseOnce(const std::string& frontend, const std::vector<Token>& tokens) {
+    Sample sample;
+    sample.tokens = tokens.size();
+    uint64_t allocations = allocationCount();
+    auto start = std::chrono::steady_clock::now();
+    try {
+#ifdef SEXPR_PARSER
+        (void)frontend;
+        Parser parser(tokens, 1);
+        Node* root = parser.parse(std::cerr);
+        sample.ms = elapsedMs(start);
+        sample.allocations = allocationCount() - allocations;
+        sample.nodes = countSExprNodes(root);
+#else
+        if (frontend == "mparser") {
+            Parser parser(tokens);
+            std::unique_ptr<ASTNode> root = parser.parse();
+            sample.ms = elapsedMs(start);
+            sample.allocations = allocationCount() - allocations;
+            sample.nodes = countASTNodes(root.get());
+        } else {
+            InfixParser parser(tokens);
+            Node* root = parser.parse(std::cerr);
+            sample.ms = elapsedMs(start);
+            sample.allocations = allocationCount() - allocations;
+            sample.nodes = countInfixNodes(root);
+        }
+#endif
+    } catch (const std::exception& e) {
+        std::cerr << frontend << ": " << e.what() << std::endl;
+        sample.ok = false;
+    }
+    return sample;
+}
+
+// Exponent k of time ~ size^k between the smallest and the largest input
+double scalingExponent(const Row& small, const Row& large) {
+    if (small.sample.ms <= 0 || large.sample.ms <= 0 || large.bytes <= small.bytes) {
+        return 0;
+    }
+    return std::log(large.sample.ms / small.sample.ms) / std::log(double(large.bytes) / small.bytes);
+}
+
+void usage() {
+    std::cerr << "usage: frontend_bench [--size=KB] [--depth=N] [--reps=N] [--shape=NAME] [--frontend=NAME]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    enableHeapAccounting();
+    size_t sizeKb = 256;
+    int depth = 32;
+    int reps = 7;
+    std::string onlyShape;
+    std::string onlyFrontend;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+        if (arg.rfind("--size=", 0) == 0) {
+            sizeKb = std::max(1, std::stoi(value()));
+        } else if (arg.rfind("--depth=", 0) == 0) {
+            depth = std::max(1, std::stoi(value()));
+        } else if (arg.rfind("--reps=", 0) == 0) {
+            reps = std::max(1, std::stoi(value()));
+        } else if (arg.rfind("--shape=", 0) == 0) {
+            onlyShape = value();
+        } else if (arg.rfind("--frontend=", 0) == 0) {
+            onlyFrontend = value();
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    struct Frontend {
+        std::string name;
+        Dialect dialect;
+        std::vector<std::string> shapes;
+    };
+#ifdef SEXPR_PARSER
+    std::vector<Frontend> frontends = {
+        {"sexpr", Dialect::SExpr, {"identifiers", "numbers", "nested"}},
+    };
+#else
+    std::vector<Frontend> frontends = {
+        {"mparser", Dialect::Scrypt, {"identifiers", "numbers", "nested", "functions"}},
+        {"infix", Dialect::Infix, {"identifiers", "numbers", "nested"}},
+    };
+#endif
+
+    std::vector<std::pair<Row, Row>> scaling;
+    bool failed = false;
+
+    std::cout << std::left << std::setw(14) << "stage" << std::setw(13) << "shape" << std::right
+              << std::setw(8) << "KB" << std::setw(10) << "tokens" << std::setw(10) << "nodes"
+              << std::setw(10) << "ms" << std::setw(9) << "MB/s" << std::setw(10) << "Mtok/s"
+              << std::setw(10) << "alloc/tok" << std::setw(11) << "alloc/node" << std::endl
+              << std::fixed;
+
+    auto print = [](const Row& row) {
+        double seconds = row.sample.ms / 1000;
+        std::cout << std::left << std::setw(14) << row.frontend << std::setw(13) << row.shape << std::right
+                  << std::setw(8) << row.bytes / 1024 << std::setw(10) << row.sample.tokens
+                  << std::setw(10) << row.sample.nodes << std::setprecision(3) << std::setw(10) << row.sample.ms
+                  << std::setprecision(1) << std::setw(9) << (seconds > 0 ? row.bytes / 1e6 / seconds : 0)
+                  << std::setprecision(2) << std::setw(10) << (seconds > 0 ? row.sample.tokens / 1e6 / seconds : 0)
+                  << std::setw(10) << (row.sample.tokens ? double(row.sample.allocations) / row.sample.tokens : 0)
+                  << std::setw(11);
+        if (row.sample.nodes) {
+            std::cout << double(row.sample.allocations) / row.sample.nodes;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::endl;
+    };
+
+    for (const Frontend& frontend : frontends) {
+        if (!onlyFrontend.empty() && onlyFrontend != frontend.name && onlyFrontend != "lexer") {
+            continue;
+        }
+        for (const std::string& shape : frontend.shapes) {
+            if (!onlyShape.empty() && onlyShape != shape) {
+                continue;
+            }
+            std::vector<Row> lexRows;
+            std::vector<Row> parseRows;
+            for (size_t scale : {1, 2, 4}) {
+                std::string source = generate(frontend.dialect, shape, sizeKb * 1024 * scale, depth);
+                Lexer lexer(source);
+                std::vector<Token> tokens = lexer.tokenize();
+
+                Row lexRow{"lexer/" + frontend.name, shape, source.size(), measure(reps, [&source]() { return lexOnce(source); })};
+                Row parseRow{frontend.name, shape, source.size(),
+                             measure(reps, [&frontend, &tokens]() { return parseOnce(frontend.name, tokens); })};
+                lexRows.push_back(lexRow);
+                print(lexRow);
+                if (onlyFrontend == "lexer") {
+                    continue;
+                }
+                if (!parseRow.sample.ok) {
+                    failed = true;
+                    break;
+                }
+                parseRows.push_back(parseRow);
+                print(parseRow);
+            }
+            scaling.push_back({lexRows.front(), lexRows.back()});
+            if (parseRows.size() > 1) {
+                scaling.push_back({parseRows.front(), parseRows.back()});
+            }
+        }
+    }
+
+    // Linear work gives an exponent near 1 and quadratic work one near 2; the
+    // flag sits in between so that timer noise on small inputs does not trip it
+    std::cout << std::endl << "scaling (time ~ size^k)" << std::endl << std::setprecision(2);
+    for (const auto& pair : scaling) {
+        double exponent = scalingExponent(pair.first, pair.second);
+        std::cout << std::left << std::setw(14) << pair.first.frontend << std::setw(13) << pair.first.shape
+                  << std::right << std::setw(6) << exponent << (exponent > 1.5 ? "  SUPERLINEAR" : "") << std::endl;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+#include "../src/lib/Interpreter.h"
+#include "../src/lib/mParser.h"
+#include "../src/lib/lex.h"
+#include "../src/lib/Stats.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Memory footprint benchmark. Runs each Scrypt program once with the heap
+// accounting of lib/stats.cpp and reports, overall and per heap category:
+//   peak     - the highest live heap while lexing, parsing and executing
+//   steady   - what is still live once the program has finished but its tokens,
+//              AST and global scope are still held, as in a worker between runs
+//   retained - what stays allocated after all of them are released (leaks and
+//              reference cycles between closures and scopes)
+// Sizes are requested bytes, without allocator overhead.
+
+const int Categories = static_cast<int>(HeapCategory::Count);
+
+struct Footprint {
+    std::string script;
+    bool ok = true;
+    uint64_t peak = 0;
+    uint64_t steady = 0;
+    int64_t retained = 0;
+    uint64_t categoryPeak[Categories] = {};
+    uint64_t categorySteady[Categories] = {};
+    uint64_t categoryAllocations[Categories] = {};
+};
+
+struct BaselineEntry {
+    std::string script;
+    double peak = 0;
+    double steady = 0;
+};
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+Footprint measure(const std::string& script, const std::string& source) {
+    static NullBuffer nullBuffer;
+    static std::ostream nullStream(&nullBuffer);
+    Footprint footprint;
+    footprint.script = script;
+    std::ostream* previousOutput = scriptOutput;
+    scriptOutput = &nullStream;
+
+    uint64_t liveBefore = liveHeapBytes();
+    HeapUsage before[Categories];
+    for (int i = 0; i < Categories; ++i) {
+        before[i] = heapUsage(static_cast<HeapCategory>(i));
+    }
+    resetHeapPeaks();
+    {
+        std::shared_ptr<Scope> globalScope;
+        {
+            HeapCategoryScope heap(HeapCategory::Scopes);
+            globalScope = Scope::create();
+        }
+        registerBuiltins(globalScope);
+        Lexer lexer(source);
+        std::vector<Token> tokens = lexer.tokenize();
+        std::unique_ptr<ASTNode> ast;
+        try {
+            if (lexer.isSyntaxError(tokens, nullStream)) {
+                footprint.ok = false;
+            } else {
+                Parser parser(tokens);
+                ast = parser.parse();
+                evaluateProgram(static_cast<const BlockNode*>(ast.get()), globalScope);
+            }
+        } catch (...) {
+            footprint.ok = false;
+        }
+        // Blocks cached by the scope pool are free memory, not part of the program
+        Scope::trimPool();
+        footprint.peak = peakHeapBytes() - liveBefore;
+        footprint.steady = liveHeapBytes() - liveBefore;
+        for (int i = 0; i < Categories; ++i) {
+            HeapUsage usage = heapUsage(static_cast<HeapCategory>(i));
+            footprint.categoryPeak[i] = usage.peakBytes - before[i].liveBytes;
+            footprint.categorySteady[i] = usage.liveBytes - before[i].liveBytes;
+            footprint.categoryAllocations[i] = usage.allocations - before[i].allocations;
+        }
+    }
+    Scope::trimPool();
+    footprint.retained = static_cast<int64_t>(liveHeapBytes()) - static_cast<int64_t>(liveBefore);
+    scriptOutput = previousOutput;
+    return footprint;
+}
+
+// Value of "key": "..." inside one flat JSON object
+std::string jsonString(const std::string& object, const std::string& key) {
+    size_t pos = object.find("\"" + key + "\"");
+    if (pos == std::string::npos) return "";
+    size_t start = object.find('"', object.find(':', pos) + 1);
+    size_t end = object.find('"', start + 1);
+    return object.substr(start + 1, end - start - 1);
+}
+
+// Value of "key": number inside one flat JSON object, or fallback when missing
+double jsonNumber(const std::string& object, const std::string& key, double fallback) {
+    size_t pos = object.find("\"" + key + "\"");
+    if (pos == std::string::npos) return fallback;
+    return std::stod(object.substr(object.find(':', pos) + 1));
+}
+
+// Reads the "results" array written by --write-baseline
+std::vector<BaselineEntry> readBaseline(const std::string& path) {
+    std::vector<BaselineEntry> entries;
+    std::string text = readFile(path);
+    size_t pos = text.find("\"results\"");
+    if (pos == std::string::npos) {
+        return entries;
+    }
+    while ((pos = text.find('{', pos)) != std::string::npos) {
+        size_t end = text.find('}', pos);
+        std::string object = text.substr(pos, end - pos + 1);
+        entries.push_back({jsonString(object, "script"), jsonNumber(object, "peakBytes", 0), jsonNumber(object, "steadyBytes", 0)});
+        pos = end;
+    }
+    return entries;
+}
+
+void writeJson(std::ostream& os, const std::vector<Footprint>& results, bool categories) {
+    os << "{\"results\": [";
+    for (size_t r = 0; r < results.size(); ++r) {
+        const Footprint& footprint = results[r];
+        os << (r > 0 ? "," : "") << "\n  {\"script\": \"" << footprint.script << "\", \"peakBytes\": " << footprint.peak
+           << ", \"steadyBytes\": " << footprint.steady << ", \"retainedBytes\": " << footprint.retained;
+        if (categories) {
+            os << ", \"categories\": [";
+            for (int i = 0; i < Categories; ++i) {
+                os << (i > 0 ? ", " : "") << "[\"" << heapCategoryName(static_cast<HeapCategory>(i)) << "\", "
+                   << footprint.categoryPeak[i] << ", " << footprint.categorySteady[i] << ", "
+                   << footprint.categoryAllocations[i] << "]";
+            }
+            os << "]";
+        }
+        os << "}";
+    }
+    os << "\n]}" << std::endl;
+}
+
+void usage() {
+    std::cerr << "usage: memory_bench [--dir=DIR] [--baseline=FILE] [--threshold=PCT] [--write-baseline=FILE] "
+                 "[--json] [script.scr ...]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    enableHeapAccounting();
+    std::string dir = "bench";
+    double threshold = 5;
+    std::string baselinePath;
+    std::string writePath;
+    bool json = false;
+    std::vector<std::string> scripts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+        if (arg.rfind("--dir=", 0) == 0) {
+            dir = value();
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            baselinePath = value();
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::stod(value());
+        } else if (arg.rfind("--write-baseline=", 0) == 0) {
+            writePath = value();
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            usage();
+            return 2;
+        } else {
+            scripts.push_back(arg);
+        }
+    }
+    if (scripts.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (entry.path().extension() == ".scr") {
+                scripts.push_back(entry.path().string());
+            }
+        }
+        std::sort(scripts.begin(), scripts.end());
+    }
+    if (scripts.empty()) {
+        std::cerr << "No benchmark scripts found in " << dir << std::endl;
+        return 2;
+    }
+
+    std::vector<Footprint> results;
+    bool failed = false;
+    for (const auto& path : scripts) {
+        results.push_back(measure(std::filesystem::path(path).filename().string(), readFile(path)));
+        if (!results.back().ok) {
+            std::cerr << results.back().script << " failed" << std::endl;
+            failed = true;
+        }
+    }
+
+    std::vector<BaselineEntry> baseline;
+    if (!baselinePath.empty()) {
+        baseline = readBaseline(baselinePath);
+    }
+
+    if (json) {
+        writeJson(std::cout, results, true);
+    } else {
+        std::cout << std::fixed << std::setprecision(1);
+        for (const Footprint& footprint : results) {
+            std::cout << footprint.script << ": peak " << footprint.peak / 1024.0 << " KB, steady "
+                      << footprint.steady / 1024.0 << " KB, retained " << footprint.retained / 1024.0 << " KB" << std::endl;
+            std::cout << "  " << std::left << std::setw(10) << "category" << std::right << std::setw(12) << "peak KB"
+                      << std::setw(12) << "steady KB" << std::setw(10) << "allocs" << std::endl;
+            for (int i = 0; i < Categories; ++i) {
+                if (footprint.categoryAllocations[i] == 0 && footprint.categorySteady[i] == 0) {
+                    continue;
+                }
+                std::cout << "  " << std::left << std::setw(10) << heapCategoryName(static_cast<HeapCategory>(i))
+                          << std::right << std::setw(12) << footprint.categoryPeak[i] / 1024.0 << std::setw(12)
+                          << footprint.categorySteady[i] / 1024.0 << std::setw(10) << footprint.categoryAllocations[i]
+                          << std::endl;
+            }
+        }
+    }
+
+    // Heap sizes are deterministic, so any growth beyond the threshold is real
+    for (const Footprint& footprint : results) {
+        for (const BaselineEntry& entry : baseline) {
+            if (entry.script != footprint.script) {
+                continue;
+            }
+            auto grew = [threshold](double now, double before) { return before > 0 && (now - before) / before * 100 > threshold; };
+            if (grew(footprint.peak, entry.peak) || grew(footprint.steady, entry.steady)) {
+                std::cerr << footprint.script << ": REGRESSION, peak " << footprint.peak << " (baseline " << entry.peak
+                          << "), steady " << footprint.steady << " (baseline " << entry.steady << ") bytes" << std::endl;
+                failed = true;
+            }
+        }
+    }
+
+    if (!writePath.empty()) {
+        std::ofstream file(writePath);
+        writeJson(file, results, false);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,599 @@
+#include "../src/lib/lex.h"
+#include "../src/lib/PerfCounters.h"
+#ifdef SEXPR_PARSER
+#include "../src/lib/parse.h"
+#else
+#include "../src/lib/Interpreter.h"
+#include "../src/lib/mParser.h"
+#include "../src/lib/infixParser.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Performance fuzzer. Generates Scrypt, infix and S-expression inputs, runs
+// every phase on them and measures the cost per input byte, counted in
+// instructions when perf_event_open is allowed and in nanoseconds otherwise.
+// An input family whose cost per byte keeps growing with its size is
+// superlinear; such cases are shrunk to the smallest size that still shows the
+// growth and can be saved as regression benchmarks.
+//
+// Built normally it runs offline over the generators below. Built with
+// -DPERF_FUZZ_LIBFUZZER and -fsanitize=fuzzer it is a libFuzzer target that
+// aborts on inputs above a cost-per-byte limit. As in bench/frontend.cpp the
+// S-expression parser needs its own -DSEXPR_PARSER build; that build is
+// offline only, because the S-expression parser exits on malformed input.
+
+#if defined(PERF_FUZZ_LIBFUZZER) && defined(SEXPR_PARSER)
+#error "the libFuzzer target covers Scrypt and infix input only"
+#endif
+
+enum class Dialect { Scrypt, Infix, SExpr };
+
+const char* extension(Dialect dialect) {
+    switch (dialect) {
+        case Dialect::Scrypt: return ".scr";
+        case Dialect::Infix: return ".infix";
+        default: return ".sexpr";
+    }
+}
+
+// Cost of one input per phase; phases a dialect does not have stay at zero
+struct Cost {
+    static const int Phases = 3;
+    double values[Phases] = {0, 0, 0};
+    bool valid = true;
+};
+
+const char* phaseName(int phase) {
+    static const char* names[Cost::Phases] = {"lex", "parse", "execute"};
+    return names[phase];
+}
+
+// Reads retired instructions when the counter is available, the steady clock
+// in nanoseconds otherwise
+class Meter {
+public:
+    Meter() { perf.open(); }
+    bool instructions() const { return perf.available(1); }
+    const char* unit() const { return instructions() ? "instr" : "ns"; }
+    double now() const {
+        if (instructions()) {
+            return static_cast<double>(perf.read().values[1]);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    PerfCounters perf;
+};
+
+Meter& meter() {
+    static Meter instance;
+    return instance;
+}
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Runs every phase once. Inputs that fail to lex, parse or run are marked
+// invalid: their cost says nothing about the phase that rejected them.
+Cost measureOnce(Dialect dialect, const std::string& source) {
+    static NullBuffer nullBuffer;
+    static std::ostream nullStream(&nullBuffer);
+    Cost cost;
+    Meter& clock = meter();
+    try {
+        double start = clock.now();
+        Lexer lexer(source);
+        std::vector<Token> tokens = lexer.tokenize();
+        cost.values[0] = clock.now() - start;
+        if (lexer.isSyntaxError(tokens, nullStream)) {
+            cost.valid = false;
+            return cost;
+        }
+        start = clock.now();
+#ifdef SEXPR_PARSER
+        (void)dialect;
+        Parser parser(tokens, 1);
+        parser.parse(nullStream);
+        cost.values[1] = clock.now() - start;
+#else
+        if (dialect == Dialect::Infix) {
+            InfixParser parser(tokens);
+            parser.parse(nullStream);
+            cost.values[1] = clock.now() - start;
+            return cost;
+        }
+        Parser parser(tokens);
+        std::unique_ptr<ASTNode> ast = parser.parse();
+        cost.values[1] = clock.now() - start;
+
+        std::ostream* previousOutput = scriptOutput;
+        scriptOutput = &nullStream;
+        std::shared_ptr<Scope> globalScope = Scope::create();
+        registerBuiltins(globalScope);
+        start = clock.now();
+        try {
+            evaluateProgram(static_cast<const BlockNode*>(ast.get()), globalScope);
+        } catch (...) {
+            cost.valid = false;
+        }
+        cost.values[2] = clock.now() - start;
+        scriptOutput = previousOutput;
+#endif
+    } catch (...) {
+        cost.valid = false;
+    }
+    return cost;
+}
+
+// Cheapest of reps runs per phase, which filters out most scheduling noise
+Cost measure(Dialect dialect, const std::string& source, int reps) {
+    Cost best = measureOnce(dialect, source);
+    for (int i = 1; i < reps && best.valid; ++i) {
+        Cost cost = measureOnce(dialect, source);
+        for (int phase = 0; phase < Cost::Phases; ++phase) {
+            best.values[phase] = std::min(best.values[phase], cost.values[phase]);
+        }
+    }
+    return best;
+}
+
+// Generators. Each family builds an input from a size parameter n, so the
+// same family can be measured at n and 4n. Random families draw from rng
+// in order, so a larger n extends the input of a smaller one.
+
+std::string nestedInfix(int depth, std::mt19937& rng) {
+    std::string text = std::to_string(rng() % 10);
+    for (int level = 0; level < depth; ++level) {
+        const char* op = rng() % 2 ? " + " : " * ";
+        text = "(" + text + op + std::to_string(rng() % 10) + ")";
+    }
+    return text;
+}
+
+std::string randomInfix(int depth, std::mt19937& rng, bool identifiers) {
+    if (depth == 0 || rng() % 4 == 0) {
+        if (identifiers && rng() % 2) {
+            return "v" + std::to_string(rng() % 8);
+        }
+        return std::to_string(rng() % 100);
+    }
+    static const char* ops[] = {" + ", " - ", " * ", " < ", " == ", " & ", " | "};
+    const char* op = ops[rng() % (identifiers ? 3 : 7)];
+    std::string left = randomInfix(depth - 1, rng, identifiers);
+    std::string right = randomInfix(depth - 1, rng, identifiers);
+    return "(" + left + op + right + ")";
+}
+
+std::string randomSExpr(int depth, std::mt19937& rng) {
+    if (depth == 0 || rng() % 4 == 0) {
+        return rng() % 3 ? std::to_string(rng() % 100) : "v" + std::to_string(rng() % 8);
+    }
+    static const char* ops[] = {"+", "-", "*", "/"};
+    std::string text = std::string("(") + ops[rng() % 4];
+    int arguments = 2 + rng() % 3;
+    for (int i = 0; i < arguments; ++i) {
+        text += " " + randomSExpr(depth - 1, rng);
+    }
+    return text + ")";
+}
+
+// Random Scrypt statement over the globals v0..v7. Loops count a fresh global
+// up to a small bound so that every generated program terminates.
+std::string randomStatement(int depth, std::mt19937& rng, int& loops, const std::string& indent) {
+    std::string v = "v" + std::to_string(rng() % 8);
+    switch (depth > 0 ? rng() % 6 : rng() % 3) {
+        case 0:
+            return indent + v + " = " + randomInfix(3, rng, true) + ";\n";
+        case 1:
+            return indent + "push(list, " + v + ");\n";
+        case 2:
+            return indent + v + " = list[" + std::to_string(rng() % 3) + "] + len(list);\n";
+        case 3: {
+            std::string text = indent + "if " + v + " < " + std::to_string(rng() % 100) + " {\n";
+            text += randomStatement(depth - 1, rng, loops, indent + "    ");
+            text += indent + "} else {\n" + randomStatement(depth - 1, rng, loops, indent + "    ") + indent + "}\n";
+            return text;
+        }
+        case 4: {
+            std::string counter = "c" + std::to_string(loops++);
+            std::string text = indent + counter + " = 0;\n" + indent + "while " + counter + " < " + std::to_string(1 + rng() % 4) + " {\n";
+            text += randomStatement(depth - 1, rng, loops, indent + "    ");
+            text += indent + "    " + counter + " = " + counter + " + 1;\n" + indent + "}\n";
+            return text;
+        }
+        default: {
+            std::string name = "g" + std::to_string(loops++);
+            return indent + "def " + name + "(a) {\n" + indent + "    return a * 2 + v0;\n" + indent + "}\n" +
+                   indent + v + " = " + name + "(" + v + ");\n";
+        }
+    }
+}
+
+struct Family {
+    const char* name;
+    Dialect dialect;
+    int baseSize;     // n of the smallest input
+    int maxSize;      // cap on n, keeps the recursive parsers off the stack limit
+    bool random;
+    std::string (*generate)(int n, std::mt19937& rng);
+};
+
+#ifndef SEXPR_PARSER
+// n while loops nested in each other, the innermost updating a global. Every
+// assignment walks the whole scope chain once per level. There is no
+// indentation, so the input grows linearly with n.
+std::string scopeChain(int n, std::mt19937&) {
+    std::string text = "total = 0;\n";
+    for (int level = 0; level < n; ++level) {
+        std::string counter = "c" + std::to_string(level);
+        text += counter + " = 0;\nwhile " + counter + " < 1 {\n";
+    }
+    for (int i = 0; i < 4; ++i) {
+        text += "total = total + 1;\n";
+    }
+    for (int level = n - 1; level >= 0; --level) {
+        std::string counter = "c" + std::to_string(level);
+        text += counter + " = " + counter + " + 1;\n}\n";
+    }
+    return text + "print total;\n";
+}
+
+// n functions defined inside each other, each calling the next
+std::string nestedFunctions(int n, std::mt19937&) {
+    std::string text = "base = 1;\n";
+    for (int level = 0; level < n; ++level) {
+        text += "def f" + std::to_string(level) + "(x) {\n";
+    }
+    text += "return x + base;\n";
+    for (int level = n - 1; level >= 0; --level) {
+        text += "}\n";
+        if (level > 0) {
+            text += "return f" + std::to_string(level) + "(x);\n";
+        }
+    }
+    return text + "print f0(1);\n";
+}
+
+std::string nestedScryptExpression(int n, std::mt19937& rng) {
+    return "x = " + nestedInfix(n, rng) + ";\nprint x;\n";
+}
+
+std::string longChain(int n, std::mt19937&) {
+    std::string text = "x = 1";
+    for (int i = 0; i < n; ++i) {
+        text += " + 1";
+    }
+    return text + ";\nprint x;\n";
+}
+
+std::string arrayLiteral(int n, std::mt19937&) {
+    std::string text = "a = [0";
+    for (int i = 1; i < n; ++i) {
+        text += ", " + std::to_string(i);
+    }
+    return text + "];\nprint len(a);\n";
+}
+
+std::string randomProgram(int n, std::mt19937& rng) {
+    std::string text;
+    for (int i = 0; i < 8; ++i) {
+        text += "v" + std::to_string(i) + " = " + std::to_string(i + 1) + ";\n";
+    }
+    text += "list = [1, 2, 3];\n";
+    int loops = 0;
+    for (int i = 0; i < n; ++i) {
+        text += randomStatement(3, rng, loops, "");
+    }
+    return text;
+}
+
+std::string infixNested(int n, std::mt19937& rng) {
+    return nestedInfix(n, rng) + "\n";
+}
+
+std::string infixRandom(int n, std::mt19937& rng) {
+    std::string text = randomInfix(4, rng, true);
+    for (int i = 1; i < n; ++i) {
+        text += " + " + randomInfix(4, rng, true);
+    }
+    return text + "\n";
+}
+#else
+std::string sexprNested(int n, std::mt19937& rng) {
+    std::string text = std::to_string(rng() % 10);
+    for (int level = 0; level < n; ++level) {
+        text = std::string(rng() % 2 ? "(+ " : "(* ") + text + " " + std::to_string(rng() % 10) + ")";
+    }
+    return text + "\n";
+}
+
+std::string sexprWide(int n, std::mt19937&) {
+    std::string text = "(+";
+    for (int i = 0; i < n; ++i) {
+        text += " " + std::to_string(i % 100);
+    }
+    return text + ")\n";
+}
+
+std::string sexprRandom(int n, std::mt19937& rng) {
+    std::string text = "(+";
+    for (int i = 0; i < n; ++i) {
+        text += " " + randomSExpr(4, rng);
+    }
+    return text + ")\n";
+}
+#endif
+
+const std::vector<Family>& families() {
+    static const std::vector<Family> list = {
+#ifndef SEXPR_PARSER
+        {"scope-chain", Dialect::Scrypt, 8, 512, false, scopeChain},
+        {"nested-functions", Dialect::Scrypt, 8, 256, false, nestedFunctions},
+        {"nested-expression", Dialect::Scrypt, 32, 512, false, nestedScryptExpression},
+        {"long-chain", Dialect::Scrypt, 256, 2048, false, longChain},
+        {"array-literal", Dialect::Scrypt, 256, 1 << 16, false, arrayLiteral},
+        {"random-program", Dialect::Scrypt, 32, 4096, true, randomProgram},
+        {"infix-nested", Dialect::Infix, 32, 512, false, infixNested},
+        {"infix-random", Dialect::Infix, 64, 1 << 14, true, infixRandom},
+#else
+        {"sexpr-nested", Dialect::SExpr, 32, 1024, false, sexprNested},
+        {"sexpr-wide", Dialect::SExpr, 256, 1 << 16, false, sexprWide},
+        {"sexpr-random", Dialect::SExpr, 32, 1 << 12, true, sexprRandom},
+#endif
+    };
+    return list;
+}
+
+std::string generate(const Family& family, int n, unsigned seed) {
+    std::mt19937 rng(seed);
+    return family.generate(n, rng);
+}
+
+// Result of measuring one family at n and 4n
+struct Scaling {
+    int n = 0;
+    bool valid = true;
+    double exponent[Cost::Phases] = {0, 0, 0};
+    double perByte[Cost::Phases] = {0, 0, 0};   // at the largest size
+    std::string largest;
+};
+
+// Phases whose cost at the largest size is below this are too short to tell
+// growth from noise
+double noiseFloor() {
+    return meter().instructions() ? 2e6 : 2e5;
+}
+
+Scaling measureScaling(const Family& family, int n, unsigned seed, int reps) {
+    Scaling scaling;
+    scaling.n = n;
+    std::string small = generate(family, n, seed);
+    scaling.largest = generate(family, 4 * n, seed);
+    Cost smallCost = measure(family.dialect, small, reps);
+    Cost largeCost = measure(family.dialect, scaling.largest, reps);
+    if (!smallCost.valid || !largeCost.valid) {
+        scaling.valid = false;
+        return scaling;
+    }
+    double sizeRatio = double(scaling.largest.size()) / small.size();
+    for (int phase = 0; phase < Cost::Phases; ++phase) {
+        scaling.perByte[phase] = largeCost.values[phase] / scaling.largest.size();
+        if (largeCost.values[phase] >= noiseFloor() && smallCost.values[phase] > 0) {
+            scaling.exponent[phase] = std::log(largeCost.values[phase] / smallCost.values[phase]) / std::log(sizeRatio);
+        }
+    }
+    return scaling;
+}
+
+bool superlinear(const Scaling& scaling, double limit) {
+    for (double exponent : scaling.exponent) {
+        if (exponent > limit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Halves n while the growth is still visible, so the saved case is the
+// smallest input of the family that shows it
+Scaling minimize(const Family& family, Scaling found, unsigned seed, int reps, double limit) {
+    while (found.n / 2 >= 1) {
+        Scaling smaller = measureScaling(family, found.n / 2, seed, reps);
+        if (!smaller.valid || !superlinear(smaller, limit)) {
+            break;
+        }
+        found = smaller;
+    }
+    return found;
+}
+
+void printScaling(const std::string& label, const Scaling& scaling, double limit, const char* unit) {
+    std::cout << std::left << std::setw(26) << label << std::right << std::setw(7) << scaling.n
+              << std::setw(9) << scaling.largest.size();
+    for (int phase = 0; phase < Cost::Phases; ++phase) {
+        std::cout << std::setw(11) << std::setprecision(2) << scaling.exponent[phase] << std::setw(11)
+                  << std::setprecision(1) << scaling.perByte[phase];
+    }
+    std::cout << " " << unit << "/B" << (superlinear(scaling, limit) ? "  SUPERLINEAR" : "") << std::endl;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(26) << "family" << std::right << std::setw(7) << "n" << std::setw(9) << "bytes";
+    for (int phase = 0; phase < Cost::Phases; ++phase) {
+        std::cout << std::setw(11) << (std::string(phaseName(phase)) + " k") << std::setw(11) << "cost/B";
+    }
+    std::cout << std::endl << std::fixed;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+#ifdef PERF_FUZZ_LIBFUZZER
+
+// Cost per byte above which an input counts as a finding; PERF_FUZZ_LIMIT
+// overrides it
+double costLimit() {
+    const char* value = std::getenv("PERF_FUZZ_LIMIT");
+    return value ? std::atof(value) : (meter().instructions() ? 1e5 : 5e4);
+}
+
+// The first byte selects the dialect, the rest is the input
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    Dialect dialect = data[0] % 2 ? Dialect::Infix : Dialect::Scrypt;
+    std::string source(reinterpret_cast<const char*>(data) + 1, size - 1);
+    Cost cost = measureOnce(dialect, source);
+    if (!cost.valid) {
+        return 0;
+    }
+    for (int phase = 0; phase < Cost::Phases; ++phase) {
+        double perByte = cost.values[phase] / source.size();
+        if (perByte > costLimit()) {
+            std::cerr << phaseName(phase) << " cost " << perByte << " " << meter().unit()
+                      << " per byte exceeds the limit of " << costLimit() << std::endl;
+            std::abort();
+        }
+    }
+    return 0;
+}
+
+#else
+
+void usage() {
+    std::cerr << "usage: perf_fuzz [--seeds=N] [--reps=N] [--limit=K] [--family=NAME] [--save=DIR] [--replay FILE ...]" << std::endl;
+}
+
+// Re-measures saved cases, one row per file with its cost per byte
+int replay(const std::vector<std::string>& paths, int reps) {
+    const char* unit = meter().unit();
+    std::cout << std::left << std::setw(40) << "case" << std::right << std::setw(9) << "bytes";
+    for (int phase = 0; phase < Cost::Phases; ++phase) {
+        std::cout << std::setw(12) << phaseName(phase);
+    }
+    std::cout << "  (" << unit << " per byte)" << std::endl << std::fixed << std::setprecision(1);
+    int status = 0;
+    for (const std::string& path : paths) {
+        Dialect dialect = Dialect::Scrypt;
+        if (path.size() > 6 && path.compare(path.size() - 6, 6, ".infix") == 0) {
+            dialect = Dialect::Infix;
+        } else if (path.size() > 6 && path.compare(path.size() - 6, 6, ".sexpr") == 0) {
+            dialect = Dialect::SExpr;
+        }
+#ifdef SEXPR_PARSER
+        if (dialect != Dialect::SExpr) continue;
+#else
+        if (dialect == Dialect::SExpr) continue;
+#endif
+        std::string source = readFile(path);
+        Cost cost = measure(dialect, source, reps);
+        std::cout << std::left << std::setw(40) << path << std::right << std::setw(9) << source.size();
+        for (int phase = 0; phase < Cost::Phases; ++phase) {
+            std::cout << std::setw(12) << cost.values[phase] / std::max<size_t>(1, source.size());
+        }
+        std::cout << (cost.valid ? "" : "  INVALID") << std::endl;
+        if (!cost.valid) {
+            status = 1;
+        }
+    }
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    int seeds = 4;
+    int reps = 3;
+    double limit = 1.5;
+    std::string onlyFamily;
+    std::string saveDir;
+    std::vector<std::string> replayPaths;
+    bool replaying = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+        if (arg.rfind("--seeds=", 0) == 0) {
+            seeds = std::max(1, std::stoi(value()));
+        } else if (arg.rfind("--reps=", 0) == 0) {
+            reps = std::max(1, std::stoi(value()));
+        } else if (arg.rfind("--limit=", 0) == 0) {
+            limit = std::stod(value());
+        } else if (arg.rfind("--family=", 0) == 0) {
+            onlyFamily = value();
+        } else if (arg.rfind("--save=", 0) == 0) {
+            saveDir = value();
+        } else if (arg == "--replay") {
+            replaying = true;
+        } else if (replaying && arg.rfind("--", 0) != 0) {
+            replayPaths.push_back(arg);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (replaying) {
+        return replay(replayPaths, reps);
+    }
+
+    const char* unit = meter().unit();
+    std::cout << "cost unit: " << unit << "; k is the growth exponent of each phase from n to 4n" << std::endl;
+    printHeader();
+    int findings = 0;
+
+    for (const Family& family : families()) {
+        if (!onlyFamily.empty() && onlyFamily != family.name) {
+            continue;
+        }
+        for (int seed = 0; seed < (family.random ? seeds : 1); ++seed) {
+            std::string label = std::string(family.name) + (family.random ? "#" + std::to_string(seed) : "");
+            // Grow n until the phases cost enough to measure or the cap is hit
+            Scaling scaling;
+            for (int n = family.baseSize; 4 * n <= family.maxSize; n *= 2) {
+                scaling = measureScaling(family, n, seed, reps);
+                if (!scaling.valid || superlinear(scaling, limit)) {
+                    break;
+                }
+            }
+            if (!scaling.valid) {
+                std::cout << std::left << std::setw(26) << label << " invalid input" << std::endl;
+                continue;
+            }
+            if (!superlinear(scaling, limit)) {
+                printScaling(label, scaling, limit, unit);
+                continue;
+            }
+            ++findings;
+            Scaling minimal = minimize(family, scaling, seed, reps, limit);
+            printScaling(label, minimal, limit, unit);
+            if (!saveDir.empty()) {
+                std::string path = saveDir + "/" + family.name + "-" + std::to_string(seed) + extension(family.dialect);
+                std::ofstream file(path);
+                file << minimal.largest;
+                std::cout << "  saved " << path << std::endl;
+            }
+        }
+    }
+    std::cout << findings << " superlinear case" << (findings == 1 ? "" : "s") << std::endl;
+    return findings > 0 ? 1 : 0;
+}
+
+#endif
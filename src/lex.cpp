@@ -1,33 +1,45 @@
-
-#include "lib/lex.h"
-#include <cctype>
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-using namespace std;
-
-/* Reads the cin and creates the expression ready to send it to the lexer.
-The Lexer calls the tokensize function to create a token of each character.
-If there is a error then print that, else print the line using iomanip for formatting
-*/
-
-int main() {
-    string input;
-    char ch;
-    while (cin.get(ch)) {
-        input += ch;
-    }
-    Lexer lexer(input);
-    auto tokens = lexer.tokenize();
-
-    if (lexer.isSyntaxError(tokens)) {
-        exit(1);
-    }
-    for (const auto& token : tokens) {
-        if (token.value != "\\n"){
-            cout << right << setw(4) << token.line << setw(5) << token.column << setw(2) << "  " << token.value << endl;
-        }
-    }
-
-    return 0;
-}
+
+#include "lib/lex.h"
+#include "lib/Stats.h"
+#include <cctype>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+
+/* Reads the cin and creates the expression ready to send it to the lexer.
+The Lexer calls the tokensize function to create a token of each character.
+If there is a error then print that, else print the line using iomanip for formatting
+*/
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (!stats.parseOption(argv[i])) {
+            cerr << "Unknown option: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    string input;
+    char ch;
+    stats.beginPhase("read");
+    while (cin.get(ch)) {
+        input += ch;
+    }
+    stats.beginPhase("lex");
+    Lexer lexer(input);
+    auto tokens = lexer.tokenize();
+    stats.endPhase();
+    stats.addCount("tokens", tokens.size());
+
+    if (lexer.isSyntaxError(tokens)) {
+        exit(1);
+    }
+    stats.beginPhase("output");
+    for (const auto& token : tokens) {
+        if (token.value != "\\n"){
+            cout << right << setw(4) << token.line << setw(5) << token.column << setw(2) << "  " << token.value << endl;
+        }
+    }
+
+    return 0;
+}
@@ -1,290 +1,456 @@
-#ifndef ASTNODES_H
-#define ASTNODES_H
-
-#include "Token.h"
-#include <memory>
-#include <vector>
-#include <string>
-
-
-struct ASTNode {
-    enum class Type {
-        BinaryOpNode,
-        NumberNode,
-        BooleanNode,
-        VariableNode,
-        AssignmentNode,
-        PrintNode,
-        IfNode,
-        WhileNode,
-        BlockNode,
-        FunctionNode,
-        ReturnNode,
-        CallNode,
-        NullNode,
-        ArrayLiteralNode,
-        ArrayLookupNode,
-        ArrayAssignmentNode  
-    };
-
-    ASTNode(Type type) : nodeType(type) {}
-    virtual ~ASTNode() = default;
-
-    Type getType() const { return nodeType; }
-    virtual ASTNode* clone() const = 0;
-
-private:
-    Type nodeType;
-};
-
-// Node for binary operations 
-struct BinaryOpNode : ASTNode {
-    Token op;
-    std::unique_ptr<ASTNode> left;
-    std::unique_ptr<ASTNode> right;
-
-    BinaryOpNode(Token op, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right)
-        : ASTNode(Type::BinaryOpNode), op(op), left(std::move(left)), right(std::move(right)) {}
-
-    ASTNode* clone() const override {
-        return new BinaryOpNode(
-            op,
-            std::unique_ptr<ASTNode>(left ? left->clone() : nullptr),
-            std::unique_ptr<ASTNode>(right ? right->clone() : nullptr)
-        );
-    }
-};
-
-// Node for numeric literals
-struct NumberNode : ASTNode {
-    Token value;
-
-    explicit NumberNode(Token value)
-        : ASTNode(Type::NumberNode), value(value) {}
-
-    ASTNode* clone() const override {
-        return new NumberNode(value);
-    }
-};
-
-
-// Node for boolean literals
-struct BooleanNode : ASTNode {
-    Token value;
-
-    explicit BooleanNode(Token value)
-        : ASTNode(Type::BooleanNode), value(value) {}
-
-    ASTNode* clone() const override {
-        return new BooleanNode(value);
-    }
-};
-
-
-// Node for variables (identifiers)
-struct VariableNode : ASTNode {
-    Token identifier;
-
-    explicit VariableNode(Token identifier)
-        : ASTNode(Type::VariableNode), identifier(identifier) {}
-
-    ASTNode* clone() const override {
-        return new VariableNode(identifier);
-    }
-};
-
-
-// Node for assignment statements
-struct AssignmentNode : ASTNode {
-    std::unique_ptr<ASTNode> lhs; 
-    std::unique_ptr<ASTNode> rhs; 
-
-    AssignmentNode(std::unique_ptr<ASTNode> lhs, std::unique_ptr<ASTNode> rhs)
-        : ASTNode(Type::AssignmentNode), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
-
-    ASTNode* clone() const override {
-        return new AssignmentNode(
-            std::unique_ptr<ASTNode>(lhs->clone()),
-            std::unique_ptr<ASTNode>(rhs->clone())
-        );
-    }
-};
-
-
-// Node for print statements
-struct PrintNode : ASTNode {
-    std::unique_ptr<ASTNode> expression;
-
-    explicit PrintNode(std::unique_ptr<ASTNode> expression)
-        : ASTNode(Type::PrintNode), expression(std::move(expression)) {}
-
-    ASTNode* clone() const override {
-        return new PrintNode(std::unique_ptr<ASTNode>(expression->clone()));
-    }
-};
-
-struct NullNode : ASTNode {
-    NullNode() : ASTNode(Type::NullNode) {}
-
-    ASTNode* clone() const override {
-        return new NullNode(*this);
-    }
-};
-// Node for if statements
-struct IfNode : ASTNode {
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> trueBranch;
-    std::unique_ptr<ASTNode> falseBranch;
-
-    IfNode(std::unique_ptr<ASTNode> condition,
-           std::unique_ptr<ASTNode> trueBranch,
-           std::unique_ptr<ASTNode> falseBranch)
-        : ASTNode(Type::IfNode),
-          condition(std::move(condition)),
-          trueBranch(std::move(trueBranch)),
-          falseBranch(std::move(falseBranch)) {}
-
-    ASTNode* clone() const override {
-        return new IfNode(
-            std::unique_ptr<ASTNode>(condition ? condition->clone() : nullptr),
-            std::unique_ptr<ASTNode>(trueBranch ? trueBranch->clone() : nullptr),
-            std::unique_ptr<ASTNode>(falseBranch ? falseBranch->clone() : nullptr)
-        );
-    }
-};
-
-// Node for while loops
-struct WhileNode : ASTNode {
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> body;
-
-    WhileNode(std::unique_ptr<ASTNode> condition, std::unique_ptr<ASTNode> body)
-        : ASTNode(Type::WhileNode), condition(std::move(condition)), body(std::move(body)) {}
-
-    ASTNode* clone() const override {
-        return new WhileNode(
-            std::unique_ptr<ASTNode>(condition->clone()),
-            std::unique_ptr<ASTNode>(body->clone())
-        );
-    }
-};
-
-
-// Node for block of statements (compound statement)
-struct BlockNode : ASTNode {
-    std::vector<std::unique_ptr<ASTNode>> statements;
-
-    BlockNode(std::vector<std::unique_ptr<ASTNode>> statements)
-        : ASTNode(Type::BlockNode), statements(std::move(statements)) {}
-
-    ASTNode* clone() const override {
-        std::vector<std::unique_ptr<ASTNode>> clonedStatements;
-        clonedStatements.reserve(statements.size());
-        for (const auto& stmt : statements) {
-            clonedStatements.push_back(std::unique_ptr<ASTNode>(stmt->clone()));
-        }
-        return new BlockNode(std::move(clonedStatements));
-    }
-};
-
-
-
-struct FunctionNode : ASTNode {
-    Token name;
-    std::vector<Token> parameters;
-    std::unique_ptr<ASTNode> body;
-
-    // Constructor
-    FunctionNode(Token name, std::vector<Token> parameters, std::unique_ptr<ASTNode> body)
-        : ASTNode(Type::FunctionNode), name(std::move(name)), parameters(std::move(parameters)), body(std::move(body)) {}
-
-    // Copy constructor
-    FunctionNode(const FunctionNode& other)
-        : ASTNode(Type::FunctionNode), name(other.name), parameters(other.parameters) {
-        if (other.body) {
-            body = std::unique_ptr<ASTNode>(other.body->clone());
-        }
-    }
-
-    FunctionNode& operator=(const FunctionNode& other) {
-        if (this != &other) {
-            name = other.name;
-            parameters = other.parameters;
-            body = other.body ? std::unique_ptr<ASTNode>(other.body->clone()) : nullptr;
-        }
-        return *this;
-    }
-
-    ASTNode* clone() const override {
-        return new FunctionNode(*this);
-    }
-};
-
-struct ReturnNode : ASTNode {
-    std::unique_ptr<ASTNode> value;
-
-    explicit ReturnNode(std::unique_ptr<ASTNode> value)
-        : ASTNode(Type::ReturnNode), value(std::move(value)) {}
-
-    ASTNode* clone() const override {
-        return new ReturnNode(
-            std::unique_ptr<ASTNode>(value ? value->clone() : nullptr)
-        );
-    }
-};
-
-struct CallNode : ASTNode {
-    std::unique_ptr<ASTNode> callee;
-    std::vector<std::unique_ptr<ASTNode>> arguments;
-
-    CallNode(std::unique_ptr<ASTNode> callee, std::vector<std::unique_ptr<ASTNode>> arguments)
-        : ASTNode(Type::CallNode), callee(std::move(callee)), arguments(std::move(arguments)) {}
-
-    ASTNode* clone() const override {
-        std::vector<std::unique_ptr<ASTNode>> clonedArguments;
-        clonedArguments.reserve(arguments.size());
-        for (const auto& arg : arguments) {
-            clonedArguments.push_back(std::unique_ptr<ASTNode>(arg->clone()));
-        }
-        return new CallNode(
-            std::unique_ptr<ASTNode>(callee->clone()),
-            std::move(clonedArguments)
-        );
-    }
-};
-
-struct ArrayLiteralNode : ASTNode {
-    std::vector<std::unique_ptr<ASTNode>> elements;
-
-    ArrayLiteralNode(std::vector<std::unique_ptr<ASTNode>> elements)
-        : ASTNode(Type::ArrayLiteralNode), elements(std::move(elements)) {}
-
-    ASTNode* clone() const override {
-        std::vector<std::unique_ptr<ASTNode>> clonedElements;
-        clonedElements.reserve(elements.size());
-        for (const auto& elem : elements) {
-            clonedElements.push_back(std::unique_ptr<ASTNode>(elem->clone()));
-        }
-        return new ArrayLiteralNode(std::move(clonedElements));
-    }
-};
-
-struct ArrayLookupNode : ASTNode {
-    std::unique_ptr<ASTNode> array;
-    std::unique_ptr<ASTNode> index;
-
-    ArrayLookupNode(std::unique_ptr<ASTNode> array, std::unique_ptr<ASTNode> index)
-        : ASTNode(Type::ArrayLookupNode), array(std::move(array)), index(std::move(index)) {}
-
-    ASTNode* clone() const override {
-        return new ArrayLookupNode(
-            std::unique_ptr<ASTNode>(array->clone()),
-            std::unique_ptr<ASTNode>(index->clone())
-        );
-    }
-};
-
-
-
-
-#endif
+#ifndef ASTNODES_H
+#define ASTNODES_H
+
+#include "Token.h"
+#include "Symbol.h"
+#include <memory>
+#include <vector>
+#include <string>
+
+class StringData;
+
+// Field names of one struct declaration in declaration order. A field's
+// position is its slot in every record of the struct.
+struct RecordLayout {
+    std::string name;
+    std::vector<Symbol> fields;
+};
+
+struct ASTNode {
+    enum class Type {
+        BinaryOpNode,
+        NumberNode,
+        BooleanNode,
+        VariableNode,
+        AssignmentNode,
+        PrintNode,
+        IfNode,
+        WhileNode,
+        BlockNode,
+        FunctionNode,
+        ReturnNode,
+        CallNode,
+        NullNode,
+        ArrayLiteralNode,
+        ArrayLookupNode,
+        ArrayAssignmentNode,
+        MapLiteralNode,
+        StringNode,
+        SliceNode,
+        StructNode,
+        FieldNode
+    };
+
+    ASTNode(Type type) : nodeType(type) {}
+    virtual ~ASTNode() = default;
+
+    Type getType() const { return nodeType; }
+    virtual ASTNode* clone() const = 0;
+
+    // Source position of the token that starts the node (0 when unknown)
+    int line = 0;
+    int column = 0;
+
+protected:
+    // Clones keep the source position so counters survive function copies
+    ASTNode* withLocation(ASTNode* copy) const {
+        copy->line = line;
+        copy->column = column;
+        return copy;
+    }
+
+private:
+    Type nodeType;
+};
+
+// Name of each node type as it appears in reports and traces
+inline const char* nodeTypeName(ASTNode::Type type) {
+    switch (type) {
+        case ASTNode::Type::BinaryOpNode: return "BinaryOpNode";
+        case ASTNode::Type::NumberNode: return "NumberNode";
+        case ASTNode::Type::BooleanNode: return "BooleanNode";
+        case ASTNode::Type::VariableNode: return "VariableNode";
+        case ASTNode::Type::AssignmentNode: return "AssignmentNode";
+        case ASTNode::Type::PrintNode: return "PrintNode";
+        case ASTNode::Type::IfNode: return "IfNode";
+        case ASTNode::Type::WhileNode: return "WhileNode";
+        case ASTNode::Type::BlockNode: return "BlockNode";
+        case ASTNode::Type::FunctionNode: return "FunctionNode";
+        case ASTNode::Type::ReturnNode: return "ReturnNode";
+        case ASTNode::Type::CallNode: return "CallNode";
+        case ASTNode::Type::NullNode: return "NullNode";
+        case ASTNode::Type::ArrayLiteralNode: return "ArrayLiteralNode";
+        case ASTNode::Type::ArrayLookupNode: return "ArrayLookupNode";
+        case ASTNode::Type::ArrayAssignmentNode: return "ArrayAssignmentNode";
+        case ASTNode::Type::MapLiteralNode: return "MapLiteralNode";
+        case ASTNode::Type::StringNode: return "StringNode";
+        case ASTNode::Type::SliceNode: return "SliceNode";
+        case ASTNode::Type::StructNode: return "StructNode";
+        case ASTNode::Type::FieldNode: return "FieldNode";
+    }
+    return "Unknown";
+}
+
+// Node for binary operations 
+struct BinaryOpNode : ASTNode {
+    Token op;
+    std::unique_ptr<ASTNode> left;
+    std::unique_ptr<ASTNode> right;
+
+    BinaryOpNode(Token op, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right)
+        : ASTNode(Type::BinaryOpNode), op(op), left(std::move(left)), right(std::move(right)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new BinaryOpNode(
+            op,
+            std::unique_ptr<ASTNode>(left ? left->clone() : nullptr),
+            std::unique_ptr<ASTNode>(right ? right->clone() : nullptr)
+        ));
+    }
+};
+
+// Node for numeric literals
+struct NumberNode : ASTNode {
+    Token value;
+
+    explicit NumberNode(Token value)
+        : ASTNode(Type::NumberNode), value(value) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new NumberNode(value));
+    }
+};
+
+// Node for string literals; value.value holds the text with escapes resolved.
+// The interpreter caches the interned string on first evaluation.
+struct StringNode : ASTNode {
+    Token value;
+    mutable std::shared_ptr<const StringData> text;
+
+    explicit StringNode(Token value)
+        : ASTNode(Type::StringNode), value(value) {}
+
+    ASTNode* clone() const override {
+        StringNode* copy = new StringNode(value);
+        copy->text = text;
+        return withLocation(copy);
+    }
+};
+
+// Node for boolean literals
+struct BooleanNode : ASTNode {
+    Token value;
+
+    explicit BooleanNode(Token value)
+        : ASTNode(Type::BooleanNode), value(value) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new BooleanNode(value));
+    }
+};
+
+
+// Node for variables (identifiers)
+struct VariableNode : ASTNode {
+    Token identifier;
+    Symbol symbol;   // interned identifier.value
+
+    explicit VariableNode(Token identifier)
+        : ASTNode(Type::VariableNode), identifier(identifier), symbol(intern(identifier.value)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new VariableNode(identifier));
+    }
+};
+
+
+// Node for assignment statements
+struct AssignmentNode : ASTNode {
+    std::unique_ptr<ASTNode> lhs; 
+    std::unique_ptr<ASTNode> rhs; 
+
+    AssignmentNode(std::unique_ptr<ASTNode> lhs, std::unique_ptr<ASTNode> rhs)
+        : ASTNode(Type::AssignmentNode), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new AssignmentNode(
+            std::unique_ptr<ASTNode>(lhs->clone()),
+            std::unique_ptr<ASTNode>(rhs->clone())
+        ));
+    }
+};
+
+
+// Node for print statements
+struct PrintNode : ASTNode {
+    std::unique_ptr<ASTNode> expression;
+
+    explicit PrintNode(std::unique_ptr<ASTNode> expression)
+        : ASTNode(Type::PrintNode), expression(std::move(expression)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new PrintNode(std::unique_ptr<ASTNode>(expression->clone())));
+    }
+};
+
+struct NullNode : ASTNode {
+    NullNode() : ASTNode(Type::NullNode) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new NullNode(*this));
+    }
+};
+// Node for if statements
+struct IfNode : ASTNode {
+    std::unique_ptr<ASTNode> condition;
+    std::unique_ptr<ASTNode> trueBranch;
+    std::unique_ptr<ASTNode> falseBranch;
+
+    IfNode(std::unique_ptr<ASTNode> condition,
+           std::unique_ptr<ASTNode> trueBranch,
+           std::unique_ptr<ASTNode> falseBranch)
+        : ASTNode(Type::IfNode),
+          condition(std::move(condition)),
+          trueBranch(std::move(trueBranch)),
+          falseBranch(std::move(falseBranch)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new IfNode(
+            std::unique_ptr<ASTNode>(condition ? condition->clone() : nullptr),
+            std::unique_ptr<ASTNode>(trueBranch ? trueBranch->clone() : nullptr),
+            std::unique_ptr<ASTNode>(falseBranch ? falseBranch->clone() : nullptr)
+        ));
+    }
+};
+
+// Node for while loops
+struct WhileNode : ASTNode {
+    std::unique_ptr<ASTNode> condition;
+    std::unique_ptr<ASTNode> body;
+
+    WhileNode(std::unique_ptr<ASTNode> condition, std::unique_ptr<ASTNode> body)
+        : ASTNode(Type::WhileNode), condition(std::move(condition)), body(std::move(body)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new WhileNode(
+            std::unique_ptr<ASTNode>(condition->clone()),
+            std::unique_ptr<ASTNode>(body->clone())
+        ));
+    }
+};
+
+
+// Node for block of statements (compound statement)
+struct BlockNode : ASTNode {
+    std::vector<std::unique_ptr<ASTNode>> statements;
+
+    BlockNode(std::vector<std::unique_ptr<ASTNode>> statements)
+        : ASTNode(Type::BlockNode), statements(std::move(statements)) {}
+
+    ASTNode* clone() const override {
+        std::vector<std::unique_ptr<ASTNode>> clonedStatements;
+        clonedStatements.reserve(statements.size());
+        for (const auto& stmt : statements) {
+            clonedStatements.push_back(std::unique_ptr<ASTNode>(stmt->clone()));
+        }
+        return withLocation(new BlockNode(std::move(clonedStatements)));
+    }
+};
+
+
+
+struct FunctionNode : ASTNode {
+    Token name;
+    std::vector<Token> parameters;
+    std::unique_ptr<ASTNode> body;
+    Symbol nameSymbol;                     // interned name.value
+    std::vector<Symbol> parameterSymbols;  // interned parameter names
+
+    // Constructor
+    FunctionNode(Token name, std::vector<Token> parameters, std::unique_ptr<ASTNode> body)
+        : ASTNode(Type::FunctionNode), name(std::move(name)), parameters(std::move(parameters)), body(std::move(body)) {
+        nameSymbol = intern(this->name.value);
+        for (const Token& parameter : this->parameters) {
+            parameterSymbols.push_back(intern(parameter.value));
+        }
+    }
+
+    // Copy constructor
+    FunctionNode(const FunctionNode& other)
+        : ASTNode(Type::FunctionNode), name(other.name), parameters(other.parameters),
+          nameSymbol(other.nameSymbol), parameterSymbols(other.parameterSymbols) {
+        line = other.line;
+        column = other.column;
+        if (other.body) {
+            body = std::unique_ptr<ASTNode>(other.body->clone());
+        }
+    }
+
+    FunctionNode& operator=(const FunctionNode& other) {
+        if (this != &other) {
+            name = other.name;
+            parameters = other.parameters;
+            nameSymbol = other.nameSymbol;
+            parameterSymbols = other.parameterSymbols;
+            body = other.body ? std::unique_ptr<ASTNode>(other.body->clone()) : nullptr;
+        }
+        return *this;
+    }
+
+    ASTNode* clone() const override {
+        return withLocation(new FunctionNode(*this));
+    }
+};
+
+struct ReturnNode : ASTNode {
+    std::unique_ptr<ASTNode> value;
+
+    explicit ReturnNode(std::unique_ptr<ASTNode> value)
+        : ASTNode(Type::ReturnNode), value(std::move(value)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new ReturnNode(
+            std::unique_ptr<ASTNode>(value ? value->clone() : nullptr)
+        ));
+    }
+};
+
+struct CallNode : ASTNode {
+    std::unique_ptr<ASTNode> callee;
+    std::vector<std::unique_ptr<ASTNode>> arguments;
+
+    CallNode(std::unique_ptr<ASTNode> callee, std::vector<std::unique_ptr<ASTNode>> arguments)
+        : ASTNode(Type::CallNode), callee(std::move(callee)), arguments(std::move(arguments)) {}
+
+    ASTNode* clone() const override {
+        std::vector<std::unique_ptr<ASTNode>> clonedArguments;
+        clonedArguments.reserve(arguments.size());
+        for (const auto& arg : arguments) {
+            clonedArguments.push_back(std::unique_ptr<ASTNode>(arg->clone()));
+        }
+        return withLocation(new CallNode(
+            std::unique_ptr<ASTNode>(callee->clone()),
+            std::move(clonedArguments)
+        ));
+    }
+};
+
+struct ArrayLiteralNode : ASTNode {
+    std::vector<std::unique_ptr<ASTNode>> elements;
+
+    ArrayLiteralNode(std::vector<std::unique_ptr<ASTNode>> elements)
+        : ASTNode(Type::ArrayLiteralNode), elements(std::move(elements)) {}
+
+    ASTNode* clone() const override {
+        std::vector<std::unique_ptr<ASTNode>> clonedElements;
+        clonedElements.reserve(elements.size());
+        for (const auto& elem : elements) {
+            clonedElements.push_back(std::unique_ptr<ASTNode>(elem->clone()));
+        }
+        return withLocation(new ArrayLiteralNode(std::move(clonedElements)));
+    }
+};
+
+// {key: value, ...}; keys and values are evaluated in source order
+struct MapLiteralNode : ASTNode {
+    std::vector<std::unique_ptr<ASTNode>> keys;
+    std::vector<std::unique_ptr<ASTNode>> values;
+
+    MapLiteralNode(std::vector<std::unique_ptr<ASTNode>> keys, std::vector<std::unique_ptr<ASTNode>> values)
+        : ASTNode(Type::MapLiteralNode), keys(std::move(keys)), values(std::move(values)) {}
+
+    ASTNode* clone() const override {
+        std::vector<std::unique_ptr<ASTNode>> clonedKeys;
+        std::vector<std::unique_ptr<ASTNode>> clonedValues;
+        clonedKeys.reserve(keys.size());
+        clonedValues.reserve(values.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            clonedKeys.push_back(std::unique_ptr<ASTNode>(keys[i]->clone()));
+            clonedValues.push_back(std::unique_ptr<ASTNode>(values[i]->clone()));
+        }
+        return withLocation(new MapLiteralNode(std::move(clonedKeys), std::move(clonedValues)));
+    }
+};
+
+struct ArrayLookupNode : ASTNode {
+    std::unique_ptr<ASTNode> array;
+    std::unique_ptr<ASTNode> index;
+
+    ArrayLookupNode(std::unique_ptr<ASTNode> array, std::unique_ptr<ASTNode> index)
+        : ASTNode(Type::ArrayLookupNode), array(std::move(array)), index(std::move(index)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new ArrayLookupNode(
+            std::unique_ptr<ASTNode>(array->clone()),
+            std::unique_ptr<ASTNode>(index->clone())
+        ));
+    }
+};
+
+// a[begin:end]; an omitted bound (null) means the start or the end
+struct SliceNode : ASTNode {
+    std::unique_ptr<ASTNode> array;
+    std::unique_ptr<ASTNode> begin;
+    std::unique_ptr<ASTNode> end;
+
+    SliceNode(std::unique_ptr<ASTNode> array, std::unique_ptr<ASTNode> begin, std::unique_ptr<ASTNode> end)
+        : ASTNode(Type::SliceNode), array(std::move(array)), begin(std::move(begin)), end(std::move(end)) {}
+
+    ASTNode* clone() const override {
+        return withLocation(new SliceNode(
+            std::unique_ptr<ASTNode>(array->clone()),
+            std::unique_ptr<ASTNode>(begin ? begin->clone() : nullptr),
+            std::unique_ptr<ASTNode>(end ? end->clone() : nullptr)
+        ));
+    }
+};
+
+// struct Name { field, ... }. The interpreter binds Name to a constructor
+// taking one value per field. The layout of its records is made by the parser
+// and shared by every clone of the node, so records made through different
+// copies of a function body that declares the struct stay comparable.
+struct StructNode : ASTNode {
+    Token name;
+    std::vector<Token> fields;
+    Symbol nameSymbol;                  // interned name.value
+    std::vector<Symbol> fieldSymbols;   // interned field names
+    std::shared_ptr<const RecordLayout> layout;
+
+    StructNode(Token name, std::vector<Token> fields)
+        : ASTNode(Type::StructNode), name(std::move(name)), fields(std::move(fields)) {
+        nameSymbol = intern(this->name.value);
+        for (const Token& field : this->fields) {
+            fieldSymbols.push_back(intern(field.value));
+        }
+        layout = std::make_shared<RecordLayout>(RecordLayout{this->name.value, fieldSymbols});
+    }
+
+    ASTNode* clone() const override {
+        StructNode* copy = new StructNode(name, fields);
+        copy->layout = layout;
+        return withLocation(copy);
+    }
+};
+
+// record.field. slot caches where the field was found last time, which is
+// where it is again as long as records of the same struct reach this node.
+struct FieldNode : ASTNode {
+    std::unique_ptr<ASTNode> record;
+    Token field;
+    Symbol fieldSymbol;   // interned field.value
+    mutable size_t slot = 0;
+
+    FieldNode(std::unique_ptr<ASTNode> record, Token field)
+        : ASTNode(Type::FieldNode), record(std::move(record)), field(std::move(field)) {
+        fieldSymbol = intern(this->field.value);
+    }
+
+    ASTNode* clone() const override {
+        FieldNode* copy = new FieldNode(std::unique_ptr<ASTNode>(record->clone()), field);
+        copy->slot = slot;
+        return withLocation(copy);
+    }
+};
+
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef ARRAY_DATA_H
+#define ARRAY_DATA_H
+
+#include "ScryptComponents.h"
+#include "Stats.h"
+#include <memory>
+#include <vector>
+
+// Storage of one array value. Arrays are shared by reference, so every Value
+// naming an array points at the same ArrayData.
+// A slice (a[i:j] or slice(a, i, j)) starts as a view: it reads a range of
+// its source array's elements in place instead of copying them. The range is
+// copied the first time either side is written. Writing to a view copies its
+// range first, and writing to a source first gives each of its views its own
+// copy, so the elements of a source never change while it has views. Views
+// are always of an array that owns its elements; a slice of a view refers to
+// the view's source directly.
+
+class ArrayData {
+public:
+    explicit ArrayData(std::vector<Value> elements) : own(std::move(elements)) {}
+
+    // View of length elements of source starting at begin
+    ArrayData(std::shared_ptr<ArrayData> viewed, size_t begin, size_t length)
+        : source(std::move(viewed)), begin(begin), length(length) {
+        nextView = source->firstView;
+        if (nextView) {
+            nextView->previousView = this;
+        }
+        source->firstView = this;
+    }
+
+    ~ArrayData() {
+        if (source) {
+            unlink();
+        }
+    }
+
+    ArrayData(const ArrayData&) = delete;
+    ArrayData& operator=(const ArrayData&) = delete;
+
+    bool isView() const { return source != nullptr; }
+    size_t size() const { return source ? length : own.size(); }
+    const Value* data() const { return source ? source->own.data() + begin : own.data(); }
+
+    // The source and offset a slice of this array starting at offset views
+    std::shared_ptr<ArrayData> viewSource(const std::shared_ptr<ArrayData>& self, size_t& offset) const {
+        if (source) {
+            offset += begin;
+            return source;
+        }
+        return self;
+    }
+
+    // The elements for writing, after detaching this array from its source
+    // and from its views
+    std::vector<Value>& elements() {
+        if (source) {
+            copyRange();
+        }
+        while (firstView) {
+            firstView->copyRange();
+        }
+        return own;
+    }
+
+private:
+    // Turns a view into an array that owns a copy of its range
+    void copyRange() {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        const Value* first = source->own.data() + begin;
+        own.assign(first, first + length);
+        unlink();
+        source.reset();
+    }
+
+    void unlink() {
+        if (previousView) {
+            previousView->nextView = nextView;
+        } else {
+            source->firstView = nextView;
+        }
+        if (nextView) {
+            nextView->previousView = previousView;
+        }
+        previousView = nullptr;
+        nextView = nullptr;
+    }
+
+    std::vector<Value> own;
+    std::shared_ptr<ArrayData> source;
+    size_t begin = 0;
+    size_t length = 0;
+    // Views of this array, and a view's neighbours in its source's list
+    ArrayData* firstView = nullptr;
+    ArrayData* previousView = nullptr;
+    ArrayData* nextView = nullptr;
+};
+
+#endif // ARRAY_DATA_H
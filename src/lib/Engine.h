@@ -0,0 +1,26 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "Interpreter.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Execution engines that can run a whole Scrypt program. Every engine takes
+// the program source, writes print output and error messages to out and
+// returns the scrypt exit code, so tools can run and compare them in-process.
+
+struct Engine {
+    const char* name;
+    int (*run)(const std::string& source, std::ostream& out);
+};
+
+// All engines built into this binary; the first one is the reference
+inline const std::vector<Engine>& engines() {
+    static const std::vector<Engine> all = {
+        {"tree-walker", runScript},
+    };
+    return all;
+}
+
+#endif // ENGINE_H
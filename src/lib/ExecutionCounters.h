@@ -0,0 +1,51 @@
+#ifndef EXECUTION_COUNTERS_H
+#define EXECUTION_COUNTERS_H
+
+#include "ASTNodes.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Exact execution counters for the Scrypt evaluator.
+// Counts are keyed on the line and column each node was parsed from rather than
+// on node addresses, because function bodies are cloned every time a def runs.
+
+struct NodeCounts {
+    ASTNode::Type type;
+    int line;
+    int column;
+    uint64_t executions = 0;   // times the statement was evaluated
+    uint64_t taken = 0;        // IfNode: condition was true
+    uint64_t notTaken = 0;     // IfNode: condition was false
+    uint64_t iterations = 0;   // WhileNode: body executions
+    uint64_t calls = 0;        // FunctionNode: calls into the function
+
+    NodeCounts(ASTNode::Type type, int line, int column)
+        : type(type), line(line), column(column) {}
+};
+
+class ExecutionCounters {
+public:
+    void countStatement(const ASTNode* node);
+    void countBranch(const IfNode* node, bool taken);
+    void countIteration(const WhileNode* node);
+    void countCall(const FunctionNode* node);
+
+    // Counts sorted by source position
+    std::vector<NodeCounts> sorted() const;
+
+    // Source listing with the counts in the left margin and a hot-spot summary
+    void writeAnnotatedSource(std::ostream& os, const std::string& source) const;
+    void writeJson(std::ostream& os) const;
+
+private:
+    NodeCounts& entry(const ASTNode* node);
+    std::unordered_map<uint64_t, NodeCounts> counts;
+};
+
+// Set by the scrypt program when counting is requested
+extern ExecutionCounters* executionCounters;
+
+#endif // EXECUTION_COUNTERS_H
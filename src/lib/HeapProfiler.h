@@ -0,0 +1,113 @@
+#ifndef HEAP_PROFILER_H
+#define HEAP_PROFILER_H
+
+#include "Stats.h"
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Sampling heap profiler for --heap-profile. The counting allocator samples
+// about one allocation per sampleBytes allocated bytes; each sample is charged
+// to the script line being executed, the chain of script calls that led to it
+// and its heap category. A sample of size bytes stands for
+// size / (1 - exp(-size / sampleBytes)) bytes, so the estimated totals stay
+// unbiased for both small and large allocations.
+
+class HeapProfiler {
+public:
+    explicit HeapProfiler(uint64_t sampleBytes = 64 * 1024);
+    ~HeapProfiler();
+
+    // Installs and removes the allocator hooks
+    void start();
+    void stop();
+
+    // Line of the statement being executed; returns the previous one
+    int setLine(int line) {
+        int previous = currentLine;
+        currentLine = line;
+        return previous;
+    }
+    void enterCall(const std::string& name, int line) { frames.push_back({&name, line}); }
+    void leaveCall() { frames.pop_back(); }
+
+    // Remembers the live bytes of every site. The report shows this snapshot,
+    // taken when the program has finished but still holds its scopes.
+    void snapshotLive();
+
+    void writeReport(std::ostream& os, const std::string& source) const;
+
+private:
+    struct Frame {
+        const std::string* name;
+        int line;
+    };
+    using Stack = std::vector<std::pair<std::string, int>>;
+
+    struct Site {
+        HeapCategory category;
+        int line;
+        size_t stack;
+        double totalBytes = 0;
+        double liveBytes = 0;
+        double liveAtEnd = 0;
+        uint64_t samples = 0;
+    };
+
+    static uint32_t sample(HeapCategory category, uint64_t size);
+    static void release(uint32_t site, uint64_t size);
+    double weight(uint64_t size) const;
+    uint32_t currentSite(HeapCategory category);
+
+    uint64_t sampleBytes;
+    bool running = false;
+    bool snapshotTaken = false;
+    int currentLine = 0;
+    std::vector<Frame> frames;
+    std::vector<Stack> stacks;
+    std::map<Stack, size_t> stackIds;
+    std::map<std::tuple<int, int, size_t>, uint32_t> siteIds;
+    std::vector<Site> sites;   // site id n is sites[n - 1]
+};
+
+// Set when --heap-profile=FILE is given
+extern HeapProfiler* heapProfiler;
+
+// Marks the statement at line as the current allocation site for its lifetime
+class HeapProfileLine {
+public:
+    explicit HeapProfileLine(int line) {
+        if (heapProfiler) {
+            previous = heapProfiler->setLine(line);
+        }
+    }
+    ~HeapProfileLine() {
+        if (heapProfiler) {
+            heapProfiler->setLine(previous);
+        }
+    }
+
+private:
+    int previous = 0;
+};
+
+// Adds a script function call to the profiled call stack
+class HeapProfileCall {
+public:
+    HeapProfileCall(const std::string& name, int line) {
+        if (heapProfiler) {
+            heapProfiler->enterCall(name, line);
+        }
+    }
+    ~HeapProfileCall() {
+        if (heapProfiler) {
+            heapProfiler->leaveCall();
+        }
+    }
+};
+
+#endif // HEAP_PROFILER_H
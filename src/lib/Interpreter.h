@@ -0,0 +1,105 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "ASTNodes.h"
+#include "ScryptComponents.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Tree-walking evaluator for Scrypt programs. The scrypt program and the
+// benchmark tools share it, so a whole program can be run in-process.
+
+Value tokenToValue(const Token& token);
+Value evaluateExpression(const ASTNode* node, const std::shared_ptr<Scope>& currentScope);
+void evaluateBlock(const BlockNode* blockNode, const std::shared_ptr<Scope>& currentScope);
+void evaluateIf(const IfNode* ifNode, const std::shared_ptr<Scope>& currentScope);
+void evaluateWhile(const WhileNode* whileNode, const std::shared_ptr<Scope>& currentScope);
+void printValue(std::ostream& os, const Value& value);
+void evaluatePrint(const PrintNode* printNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateBinaryOperation(const BinaryOpNode* binaryOpNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateVariable(const VariableNode* variableNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateAssignment(const AssignmentNode* assignmentNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateFunctionCall(const CallNode* node, const std::shared_ptr<Scope>& currentScope);
+void evaluateFunctionDefinition(const FunctionNode* functionNode, const std::shared_ptr<Scope>& currentScope);
+void evaluateReturn(const ReturnNode* returnNode, const std::shared_ptr<Scope>& currentScope);
+void evaluateStatement(const ASTNode* stmt, const std::shared_ptr<Scope>& currentScope);
+void evaluateProgram(const BlockNode* program, const std::shared_ptr<Scope>& currentScope);
+Value evaluateArrayLiteralNode(const ArrayLiteralNode* arrayLiteralNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateMapLiteralNode(const MapLiteralNode* mapLiteralNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateArrayLookupNode(const ArrayLookupNode* arrayLookupNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateSliceNode(const SliceNode* sliceNode, const std::shared_ptr<Scope>& currentScope);
+Value evaluateFieldNode(const FieldNode* fieldNode, const std::shared_ptr<Scope>& currentScope);
+void evaluateStructDefinition(const StructNode* structNode, const std::shared_ptr<Scope>& currentScope);
+
+// Arguments of a call. The caller evaluates them straight onto the
+// interpreter's argument stack and the callee reads them in place. The stack
+// never moves values that are in use, so the window stays valid until the call
+// returns, including across calls back into script code.
+class Arguments {
+public:
+    Arguments(Value* values, size_t count) : values(values), count(count) {}
+    size_t size() const { return count; }
+    Value& operator[](size_t i) const { return values[i]; }
+
+private:
+    Value* values;
+    size_t count;
+};
+
+Value lenFunction(Arguments args);
+Value popFunction(Arguments args);
+Value pushFunction(Arguments args);
+Value hasFunction(Arguments args);
+Value deleteFunction(Arguments args);
+Value keysFunction(Arguments args);
+Value valuesFunction(Arguments args);
+Value sliceFunction(Arguments args);
+Value sortFunction(Arguments args);
+Value bsearchFunction(Arguments args);
+Value reverseFunction(Arguments args);
+Value fillFunction(Arguments args);
+Value concatFunction(Arguments args);
+Value reserveFunction(Arguments args);
+Value arrayFunction(Arguments args);
+Value psortFunction(Arguments args);
+Value pscanFunction(Arguments args);
+Value sqrtFunction(Arguments args);
+Value expFunction(Arguments args);
+Value logFunction(Arguments args);
+Value sinFunction(Arguments args);
+Value cosFunction(Arguments args);
+Value powFunction(Arguments args);
+Value absFunction(Arguments args);
+Value floorFunction(Arguments args);
+Value matrixFunction(Arguments args);
+Value shapeFunction(Arguments args);
+Value matmulFunction(Arguments args);
+Value pmatmulFunction(Arguments args);
+Value transposeFunction(Arguments args);
+Value vectorFunction(Arguments args);
+Value assocFunction(Arguments args);
+Value conjFunction(Arguments args);
+
+// Calls a script function value with args, moving them into its scope
+Value callFunction(const Value& function, Arguments args, int line);
+
+// Builtins called by name, such as has(map, key); a script function or
+// variable of the same name takes precedence. Returns nullptr for other names.
+using Builtin = Value (*)(Arguments);
+Builtin findBuiltin(Symbol name);
+
+// Adds the len, pop and push builtins to a global scope
+void registerBuiltins(std::shared_ptr<Scope> scope);
+
+// Destination of print statements (std::cout unless a caller redirects it)
+extern std::ostream* scriptOutput;
+
+// Lexes, parses and evaluates a whole program in a fresh global scope.
+// Print output and error messages go to out. The result is the scrypt exit
+// code: 0 on success, 1 for a syntax error, 2 for parse and most runtime
+// errors and 3 for the type, argument count and return errors.
+int runScript(const std::string& source, std::ostream& out);
+
+#endif // INTERPRETER_H
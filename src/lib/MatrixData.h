@@ -0,0 +1,45 @@
+#ifndef MATRIX_DATA_H
+#define MATRIX_DATA_H
+
+#include "Stats.h"
+#include <cstddef>
+#include <vector>
+
+// Storage of one matrix value: rows x columns numbers in one row-major block,
+// without a Value per element. Like arrays, matrices are shared by reference.
+
+class MatrixData {
+public:
+    MatrixData(size_t rows, size_t columns) : rowCount(rows), columnCount(columns) {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        elements.resize(rows * columns);
+    }
+
+    MatrixData(const MatrixData& other) : rowCount(other.rowCount), columnCount(other.columnCount) {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        elements = other.elements;
+    }
+
+    MatrixData(MatrixData&&) = default;
+    MatrixData& operator=(const MatrixData&) = delete;
+
+    size_t rows() const { return rowCount; }
+    size_t columns() const { return columnCount; }
+    size_t size() const { return elements.size(); }
+
+    double* data() { return elements.data(); }
+    const double* data() const { return elements.data(); }
+    double* row(size_t i) { return elements.data() + i * columnCount; }
+    const double* row(size_t i) const { return elements.data() + i * columnCount; }
+
+    bool equals(const MatrixData& other) const {
+        return rowCount == other.rowCount && columnCount == other.columnCount && elements == other.elements;
+    }
+
+private:
+    size_t rowCount;
+    size_t columnCount;
+    std::vector<double> elements;
+};
+
+#endif // MATRIX_DATA_H
@@ -0,0 +1,42 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// Linux hardware performance counters (perf_event_open) for --perf.
+// Each counter is opened on its own so that a machine or container that only
+// exposes some of them still reports the rest; counters that cannot be opened
+// are reported as unavailable instead of failing the run.
+
+struct PerfSample {
+    static const int Count = 5;
+    uint64_t values[Count] = {0, 0, 0, 0, 0};
+
+    PerfSample& operator+=(const PerfSample& other);
+    PerfSample operator-(const PerfSample& other) const;
+};
+
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    // Opens and starts the counters for this process; returns false when none
+    // of them could be opened
+    bool open();
+    bool available(int counter) const { return fds[counter] >= 0; }
+    bool anyAvailable() const;
+
+    // Current counter values since open()
+    PerfSample read() const;
+
+    static const char* name(int counter);
+
+private:
+    int fds[PerfSample::Count] = {-1, -1, -1, -1, -1};
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,43 @@
+#ifndef RECORD_DATA_H
+#define RECORD_DATA_H
+
+#include "ScryptComponents.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Storage of one record value: a slot per field of its layout, in one block.
+// Like arrays, records are shared by reference.
+class RecordData {
+public:
+    RecordData(std::shared_ptr<const RecordLayout> layout, std::vector<Value> slots)
+        : recordLayout(std::move(layout)), slots(std::move(slots)) {}
+
+    const std::shared_ptr<const RecordLayout>& layout() const { return recordLayout; }
+    size_t size() const { return slots.size(); }
+    Value& slot(size_t i) { return slots[i]; }
+    const Value& slot(size_t i) const { return slots[i]; }
+
+    // Finds the slot of field. slot holds a guess, such as the slot found
+    // last time at the same place in the script; a right guess costs one
+    // comparison. Returns false when the record has no such field.
+    bool findSlot(Symbol field, size_t& slot) const {
+        const std::vector<Symbol>& fields = recordLayout->fields;
+        if (slot < fields.size() && fields[slot] == field) {
+            return true;
+        }
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (fields[i] == field) {
+                slot = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::shared_ptr<const RecordLayout> recordLayout;
+    std::vector<Value> slots;
+};
+
+#endif // RECORD_DATA_H
@@ -0,0 +1,101 @@
+#ifndef RUN_ARENA_H
+#define RUN_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Arena for the objects of one script run. runScript activates its thread's
+// arena for the whole run; the shared holders of arrays, maps and other
+// values are then carved out of large chunks instead of coming from malloc.
+// Blocks freed during the run go on per-size free lists and are reused by the
+// run itself, and reset() at the end rewinds the arena without visiting any
+// object, keeping up to MaxKeptChunks chunks for the next run.
+// reset() runs no destructors. Everything allocated from the arena must be
+// destroyed by then: runScript first releases the scopes that closure cycles
+// keep alive (Scope::releaseRunScopes). A holder still alive at the reset,
+// such as an array that contains itself, is forgotten, and the heap memory it
+// owns, like its element buffer, leaks.
+
+class RunArena {
+public:
+    // Larger blocks go straight to the heap
+    static const size_t MaxBlockSize = 1024;
+    static const size_t ChunkSize = 64 * 1024;
+    // Chunks kept by reset(); further ones go back to the heap
+    static const size_t MaxKeptChunks = 16;
+
+    RunArena() = default;
+    ~RunArena();
+    RunArena(const RunArena&) = delete;
+    RunArena& operator=(const RunArena&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* block, size_t size);
+
+    // Forgets every block, frees the chunks beyond MaxKeptChunks and rewinds
+    // to the first chunk
+    void reset();
+
+    // Bytes handed out since the last reset, and bytes held in chunks
+    size_t usedBytes() const { return used; }
+    size_t chunkBytes() const { return chunks.size() * ChunkSize; }
+
+private:
+    static const size_t Granularity = 16;
+    static const size_t ClassCount = MaxBlockSize / Granularity;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* freeLists[ClassCount] = {};
+    std::vector<char*> chunks;
+    size_t currentChunk = 0;
+    char* next = nullptr;
+    char* end = nullptr;
+    size_t used = 0;
+};
+
+// Arena of the run in progress on this thread, if any
+extern thread_local RunArena* runArena;
+
+// Makes arena the active one for its lifetime and resets it afterwards
+class RunArenaScope {
+public:
+    explicit RunArenaScope(RunArena& arena) : arena(arena), previous(runArena) { runArena = &arena; }
+    ~RunArenaScope() {
+        runArena = previous;
+        if (previous != &arena) {
+            arena.reset();
+        }
+    }
+    RunArenaScope(const RunArenaScope&) = delete;
+    RunArenaScope& operator=(const RunArenaScope&) = delete;
+
+private:
+    RunArena& arena;
+    RunArena* previous;
+};
+
+// Standard allocator over a RunArena, for allocate_shared and containers
+template <typename T>
+struct RunAllocator {
+    using value_type = T;
+
+    explicit RunAllocator(RunArena* arena) : arena(arena) {}
+    template <typename U>
+    RunAllocator(const RunAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T))); }
+    void deallocate(T* block, size_t n) { arena->deallocate(block, n * sizeof(T)); }
+
+    RunArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const RunAllocator<T>& a, const RunAllocator<U>& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(const RunAllocator<T>& a, const RunAllocator<U>& b) { return a.arena != b.arena; }
+
+#endif // RUN_ARENA_H
@@ -1,114 +1,195 @@
-#ifndef SCRIPT_COMPONENTS_H
-#define SCRIPT_COMPONENTS_H
-
-#include <string>
-#include <unordered_map>
-#include <exception>
-#include <memory>
-#include <vector>
-#include "ASTNodes.h"
-#include <functional>
-
-class Scope;
-
-// Value class to represent different types of values in your script
-class Value {
-public:
-    using FunctionPtr = std::function<Value(std::vector<Value>&)>;
-    enum class Type { Double, Bool, Function, Null, Array, BuiltinFunction};
-
-    struct Function {
-        std::shared_ptr<FunctionNode> definition; 
-        std::shared_ptr<Scope> capturedScope;
-
-        Function() = default;
-        Function(const std::shared_ptr<FunctionNode>& def, const std::shared_ptr<Scope>& scope)
-            : definition(def), capturedScope(scope) {}
-        Function(const Function& other) 
-            : definition(other.definition), capturedScope(other.capturedScope) {}
-        Function(Function&& other) noexcept 
-            : definition(std::move(other.definition)), capturedScope(std::move(other.capturedScope)) {}
-
-        Function& operator=(const Function& other) {
-            if (this != &other) {
-                definition = other.definition;
-                capturedScope = other.capturedScope;
-            }
-            return *this;
-        }
-
-        Function& operator=(Function&& other) noexcept {
-            definition = std::move(other.definition);
-            capturedScope = std::move(other.capturedScope);
-            return *this;
-        }
-    };
-
-    Value();
-    Value(double value);
-    Value(bool value);
-    Value(Function function);
-    Value(const Value& other);
-    Value(Value&& other) noexcept;
-    Value& operator=(const Value& other);
-    Value& operator=(Value&& other) noexcept;
-    Value(std::vector<Value> array);
-    Value(FunctionPtr func);
-
-    ~Value();
-
-    Type getType() const;
-    double asDouble() const;
-    bool asBool() const;
-    const Function& asFunction() const;
-    bool isNull() const;
-    bool equals(const Value& other) const;
-
-    bool isArray() const;
-    bool isInteger() const;
-    std::vector<Value>& asArray();
-    const std::vector<Value>& asArray() const;
-    Value deepCopy() const;
-    Value executeFunction(std::vector<Value>& args) const;
-private:
-    Type type;
-    union {
-        double doubleValue;
-        bool boolValue;
-        Function functionValue;
-        std::shared_ptr<std::vector<Value>> arrayValue;
-        FunctionPtr builtinFunction; 
-    };
-
-    void cleanUp();
-    void copyFrom(const Value& other);
-    void moveFrom(Value&& other);
-};
-// Scope class for variable scoping
-class Scope {
-public:
-    Scope(std::shared_ptr<Scope> parent = nullptr) : parentScope(parent) {}
-
-    void setVariable(const std::string& name, const Value& value);
-    Value* getVariable(const std::string& name);
-    const std::unordered_map<std::string, Value>& getVariables() const;
-
-    std::shared_ptr<Scope> getParent() const;
-    std::shared_ptr<Scope> copyScope() const;
-    std::shared_ptr<Scope> deepCopy() const;
-    bool hasVariable(const std::string& name);
-
-private:
-    std::unordered_map<std::string, Value> variables;
-    std::shared_ptr<Scope> parentScope;
-};
-
-// Exception class for handling return statements
-class ReturnException : public std::exception {
-    Value returnValue;
-public:
-    explicit ReturnException(Value returnValue);
-    const Value& getValue() const;
-};
-
+#ifndef SCRIPT_COMPONENTS_H
+#define SCRIPT_COMPONENTS_H
+
+#include <string>
+#include <unordered_map>
+#include <exception>
+#include <memory>
+#include <vector>
+#include "ASTNodes.h"
+#include "SymbolMap.h"
+#include "StringValue.h"
+#include <functional>
+
+class Scope;
+class ValueMap;
+class ArrayData;
+class ArrayElements;
+class MatrixData;
+class RecordData;
+class VectorData;
+
+// Value class to represent different types of values in your script
+class Value {
+public:
+    using FunctionPtr = std::function<Value(std::vector<Value>&)>;
+    enum class Type { Double, Bool, Function, Null, Array, BuiltinFunction, Map, String, Matrix, Record, Vector };
+
+    struct Function {
+        std::shared_ptr<FunctionNode> definition; 
+        std::shared_ptr<Scope> capturedScope;
+
+        Function() = default;
+        Function(const std::shared_ptr<FunctionNode>& def, const std::shared_ptr<Scope>& scope)
+            : definition(def), capturedScope(scope) {}
+        Function(const Function& other) 
+            : definition(other.definition), capturedScope(other.capturedScope) {}
+        Function(Function&& other) noexcept 
+            : definition(std::move(other.definition)), capturedScope(std::move(other.capturedScope)) {}
+
+        Function& operator=(const Function& other) {
+            if (this != &other) {
+                definition = other.definition;
+                capturedScope = other.capturedScope;
+            }
+            return *this;
+        }
+
+        Function& operator=(Function&& other) noexcept {
+            definition = std::move(other.definition);
+            capturedScope = std::move(other.capturedScope);
+            return *this;
+        }
+    };
+
+    Value();
+    Value(double value);
+    Value(bool value);
+    Value(Function function);
+    Value(const Value& other);
+    Value(Value&& other) noexcept;
+    Value& operator=(const Value& other);
+    Value& operator=(Value&& other) noexcept;
+    Value(std::vector<Value> array);
+    Value(FunctionPtr func);
+    explicit Value(ValueMap map);
+    explicit Value(StringPtr string);
+    explicit Value(MatrixData matrix);
+    explicit Value(RecordData record);
+    explicit Value(VectorData vector);
+
+    ~Value();
+
+    Type getType() const;
+    double asDouble() const;
+    bool asBool() const;
+    const Function& asFunction() const;
+    bool isNull() const;
+    bool equals(const Value& other) const;
+
+    bool isArray() const;
+    bool isInteger() const;
+    // Writable elements; a slice gets its own copy of them first
+    std::vector<Value>& asArray();
+    ArrayElements asArray() const;
+    // New array viewing elements [begin, end) of this one without copying them
+    Value sliceArray(size_t begin, size_t end) const;
+    bool isMap() const;
+    ValueMap& asMap();
+    const ValueMap& asMap() const;
+    bool isString() const;
+    const StringPtr& asString() const;
+    bool isMatrix() const;
+    MatrixData& asMatrix();
+    const MatrixData& asMatrix() const;
+    bool isRecord() const;
+    RecordData& asRecord();
+    const RecordData& asRecord() const;
+    bool isVector() const;
+    const VectorData& asVector() const;
+    Value deepCopy() const;
+    Value executeFunction(std::vector<Value>& args) const;
+private:
+    Type type;
+    union {
+        double doubleValue;
+        bool boolValue;
+        Function functionValue;
+        std::shared_ptr<ArrayData> arrayValue;
+        FunctionPtr builtinFunction; 
+        std::shared_ptr<ValueMap> mapValue;
+        StringPtr stringValue;
+        std::shared_ptr<MatrixData> matrixValue;
+        std::shared_ptr<RecordData> recordValue;
+        std::shared_ptr<const VectorData> vectorValue;
+    };
+
+    void cleanUp();
+    void copyFrom(const Value& other);
+    void moveFrom(Value&& other);
+};
+
+// Read-only elements of an array, valid until the array or its source is
+// next written
+class ArrayElements {
+public:
+    ArrayElements(const Value* values, size_t count) : values(values), count(count) {}
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Value& operator[](size_t i) const { return values[i]; }
+    const Value* begin() const { return values; }
+    const Value* end() const { return values + count; }
+
+private:
+    const Value* values;
+    size_t count;
+};
+
+// Scope class for variable scoping. The string overloads intern the name
+// first; the evaluator passes the symbols cached in the AST.
+class Scope {
+public:
+    Scope(std::shared_ptr<Scope> parent = nullptr) : parentScope(parent) {}
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // Scopes are created through a per-thread pool that recycles the memory
+    // of destroyed scopes through free lists instead of going back to malloc.
+    // The pool owns scope memory inside and outside runs; the run arena only
+    // holds arrays and other value storage.
+    static std::shared_ptr<Scope> create(std::shared_ptr<Scope> parent = nullptr);
+    // Returns the recycled blocks held by this thread's pool to the heap
+    static void trimPool();
+    // Clears the variables of every scope created during the run on this
+    // thread that is still alive. Only reference cycles between closures and
+    // the scopes they capture keep a scope alive once a run is over, so this
+    // destroys them, and everything they hold, before the arena is reset.
+    static void releaseRunScopes();
+
+    void setVariable(const std::string& name, const Value& value);
+    void setVariable(Symbol name, const Value& value);
+    void setVariable(Symbol name, Value&& value);
+    Value* getVariable(const std::string& name);
+    Value* getVariable(Symbol name);
+    const SymbolMap<Value>& getVariables() const;
+
+    std::shared_ptr<Scope> getParent() const;
+    std::shared_ptr<Scope> copyScope() const;
+    std::shared_ptr<Scope> deepCopy() const;
+    bool hasVariable(const std::string& name);
+    bool hasVariable(Symbol name);
+
+private:
+    Value& assignmentTarget(Symbol name);
+
+    void unlinkFromRun();
+
+    SymbolMap<Value> variables;
+    std::shared_ptr<Scope> parentScope;
+    // Links between the scopes created during the current run
+    bool inRun = false;
+    Scope* previousInRun = nullptr;
+    Scope* nextInRun = nullptr;
+};
+
+// Exception class for handling return statements
+class ReturnException : public std::exception {
+    Value returnValue;
+public:
+    explicit ReturnException(Value returnValue);
+    Value& getValue();
+    const Value& getValue() const;
+};
+
 #endif // SCRIPT_COMPONENTS_H
\ No newline at end of file
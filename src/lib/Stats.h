@@ -0,0 +1,158 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PerfCounters.h"
+
+// Phase timing and allocation statistics for the --stats option.
+// Linking stats.cpp replaces the global operator new with a counting version,
+// so every tool that links it can report allocations per phase and per heap
+// category. With --perf the phases also carry hardware counter deltas.
+
+// The counting allocator only counts once heap accounting is enabled, which
+// --stats, --perf, the heap profiler and the memory benchmarks do. Until then
+// an allocation costs one flag check on top of malloc. Blocks allocated
+// before are never counted, not even when they are freed.
+void enableHeapAccounting();
+bool heapAccountingEnabled();
+
+// Totals of the counting allocator since heap accounting was enabled
+uint64_t allocationCount();
+uint64_t allocationBytes();
+
+// Per-type heap accounting. Every allocation is charged to the innermost
+// active HeapCategoryScope (Other outside of any) and remembers its category,
+// so the matching free is charged back to the same one.
+// Arena holds the chunks of the run arena (RunArena.h), which serve scopes and
+// array holders while runScript is executing. Strings holds string values
+// (StringValue.h), which always come from the heap.
+enum class HeapCategory { Other, Tokens, AST, Values, Arrays, Scopes, Closures, Arena, Strings, Count };
+
+struct HeapUsage {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;        // requested bytes, including freed blocks
+    uint64_t liveBytes = 0;
+    uint64_t peakBytes = 0;    // highest liveBytes since the last resetHeapPeaks()
+};
+
+const char* heapCategoryName(HeapCategory category);
+HeapUsage heapUsage(HeapCategory category);
+uint64_t liveHeapBytes();
+uint64_t peakHeapBytes();
+
+// Starts new peaks at the current live sizes
+void resetHeapPeaks();
+
+// Hooks of the sampling heap profiler. The sampler sees about one allocation
+// per sampleBytes allocated bytes and returns a site id that is kept with the
+// block (0 for none); release is called with that id when the block is freed.
+using AllocationSampler = uint32_t (*)(HeapCategory category, uint64_t size);
+using SampledRelease = void (*)(uint32_t site, uint64_t size);
+void setAllocationSampler(AllocationSampler sampler, SampledRelease release, uint64_t sampleBytes);
+
+extern thread_local HeapCategory activeHeapCategory;
+
+class HeapCategoryScope {
+public:
+    explicit HeapCategoryScope(HeapCategory category) : previous(activeHeapCategory) {
+        activeHeapCategory = category;
+    }
+    ~HeapCategoryScope() { activeHeapCategory = previous; }
+    HeapCategoryScope(const HeapCategoryScope&) = delete;
+    HeapCategoryScope& operator=(const HeapCategoryScope&) = delete;
+
+private:
+    HeapCategory previous;
+};
+
+struct PhaseStats {
+    std::string name;
+    double wallMs = 0;
+    double cpuMs = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    PerfSample counters;
+};
+
+// Hardware counters of one script function, inclusive of nested calls
+struct FunctionStats {
+    std::string name;
+    uint64_t calls = 0;
+    PerfSample counters;
+};
+
+class Stats {
+public:
+    // Handles --stats, --stats=json, --perf and --perf=functions, returns false
+    // for any other argument
+    bool parseOption(const std::string& arg);
+    bool enabled() const { return active; }
+
+    // True when --perf=functions asked for counters around each script function
+    bool perFunction() const { return perfFunctions; }
+    PerfSample readCounters() const { return perf.read(); }
+    void addFunction(const std::string& name, const PerfSample& counters);
+
+    // Phases with the same name accumulate, so tools that loop over input lines
+    // report one row per phase
+    void beginPhase(const std::string& name);
+    void endPhase();
+
+    void addCount(const std::string& name, uint64_t value);
+
+    void write(std::ostream& os);
+
+private:
+    struct Counter {
+        std::string name;
+        uint64_t value;
+    };
+
+    PhaseStats& phase(const std::string& name);
+    void enable();
+    void writePerfRow(std::ostream& os, const std::string& name, const PerfSample& sample) const;
+
+    bool active = false;
+    bool json = false;
+    bool perfEnabled = false;
+    bool perfFunctions = false;
+    PerfCounters perf;
+    PerfSample perfStart;
+    std::vector<PhaseStats> phases;
+    std::vector<Counter> counters;
+    std::vector<FunctionStats> functions;
+
+    std::string currentPhase;
+    std::chrono::steady_clock::time_point wallStart;
+    double cpuStart = 0;
+    uint64_t allocationsStart = 0;
+    uint64_t bytesStart = 0;
+};
+
+// Statistics of the running tool, written to standard error at exit when enabled
+extern Stats stats;
+
+// Attributes the hardware counters spent inside a script function call to it
+class FunctionCounters {
+public:
+    explicit FunctionCounters(const std::string& name) : name(name) {
+        if (stats.perFunction()) {
+            start = stats.readCounters();
+        }
+    }
+    ~FunctionCounters() {
+        if (stats.perFunction()) {
+            stats.addFunction(name, stats.readCounters() - start);
+        }
+    }
+
+private:
+    const std::string& name;
+    PerfSample start;
+};
+
+#endif // STATS_H
@@ -0,0 +1,67 @@
+#ifndef STRING_VALUE_H
+#define STRING_VALUE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Immutable string value of Scrypt. A string is either flat, holding its
+// characters, or a rope: the concatenation of two strings that is flattened
+// the first time its characters are needed. s = s + x in a loop therefore
+// appends in constant time and copies the characters once, instead of copying
+// the whole prefix on every iteration.
+// Literals and every string of at most InternLength characters are interned:
+// there is one object per distinct text, so two interned strings are equal
+// exactly when they are the same object.
+
+class StringData;
+using StringPtr = std::shared_ptr<const StringData>;
+
+class StringData : public std::enable_shared_from_this<StringData> {
+public:
+    static const size_t InternLength = 16;
+    // Longest leaf built by merging appended pieces into a rope
+    static const size_t LeafLength = 256;
+
+    // A string with the given characters, interned when it is short
+    static StringPtr make(std::string text);
+    // The interned string with the given characters
+    static StringPtr intern(const std::string& text);
+    static StringPtr concat(const StringPtr& left, const StringPtr& right);
+
+    ~StringData();
+    StringData(const StringData&) = delete;
+    StringData& operator=(const StringData&) = delete;
+
+    size_t size() const { return length; }
+    bool isInterned() const { return interned; }
+
+    // The characters, flattening a rope on first use
+    const std::string& text() const {
+        if (left) {
+            flatten();
+        }
+        return flat;
+    }
+
+    size_t hash() const;
+    bool equals(const StringData& other) const;
+    int compare(const StringData& other) const { return text().compare(other.text()); }
+
+private:
+    StringData(std::string text, bool interned);
+    StringData(StringPtr left, StringPtr right);
+
+    void flatten() const;
+    static void release(StringPtr& node);
+
+    mutable std::string flat;
+    mutable StringPtr left;
+    mutable StringPtr right;
+    mutable size_t cachedHash = 0;
+    mutable bool hashed = false;
+    size_t length;
+    bool interned;
+};
+
+#endif // STRING_VALUE_H
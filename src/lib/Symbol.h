@@ -0,0 +1,32 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Interned variable names. Each distinct name is stored once for the life of
+// the program, so two symbols are equal exactly when their pointers are, and
+// the hash is computed a single time when the name is first interned. The AST
+// interns the names it refers to, so scope lookups never hash a string.
+
+struct SymbolEntry {
+    std::string name;
+    size_t hash;
+};
+
+using Symbol = const SymbolEntry*;
+
+inline Symbol intern(const std::string& name) {
+    static std::unordered_map<std::string, std::unique_ptr<SymbolEntry>> table;
+    auto found = table.find(name);
+    if (found != table.end()) {
+        return found->second.get();
+    }
+    size_t hash = std::hash<std::string>()(name);
+    auto inserted = table.emplace(name, std::unique_ptr<SymbolEntry>(new SymbolEntry{name, hash}));
+    return inserted.first->second.get();
+}
+
+#endif // SYMBOL_H
@@ -0,0 +1,195 @@
+#ifndef SYMBOL_MAP_H
+#define SYMBOL_MAP_H
+
+#include "Symbol.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Map from interned symbols to values, used for scope variables. Scopes never
+// remove a variable, which keeps both layouts simple:
+//  - up to InlineCapacity entries live inside the map itself and are found by
+//    comparing symbol pointers, so the small scopes of loops and calls do not
+//    allocate a table at all;
+//  - larger maps use an open-addressing Robin Hood table indexed by the
+//    symbol's cached hash.
+// Growing the map moves its values, so pointers returned by find() are only
+// valid until the next insertion.
+
+template <typename V>
+class SymbolMap {
+public:
+    static const size_t InlineCapacity = 8;
+
+    SymbolMap() = default;
+
+    SymbolMap(const SymbolMap& other) {
+        other.forEach([this](Symbol key, const V& value) { (*this)[key] = value; });
+    }
+
+    SymbolMap& operator=(const SymbolMap& other) {
+        if (this != &other) {
+            clear();
+            other.forEach([this](Symbol key, const V& value) { (*this)[key] = value; });
+        }
+        return *this;
+    }
+
+    ~SymbolMap() { clear(); }
+
+    size_t size() const { return count; }
+
+    V* find(Symbol key) {
+        if (!slots) {
+            for (size_t i = 0; i < count; ++i) {
+                if (inlineKeys[i] == key) {
+                    return &inlineValues()[i];
+                }
+            }
+            return nullptr;
+        }
+        size_t mask = capacity - 1;
+        size_t pos = key->hash & mask;
+        for (size_t distance = 0;; ++distance, pos = (pos + 1) & mask) {
+            Symbol slotKey = slots[pos].key;
+            if (slotKey == key) {
+                return &slots[pos].value();
+            }
+            // Robin Hood order: once the resident is closer to its home slot
+            // than we are to ours, the key cannot be further along
+            if (!slotKey || probeDistance(slotKey, pos) < distance) {
+                return nullptr;
+            }
+        }
+    }
+
+    const V* find(Symbol key) const { return const_cast<SymbolMap*>(this)->find(key); }
+
+    // Value of key, inserting a default-constructed one when it is missing
+    V& operator[](Symbol key) {
+        if (V* existing = find(key)) {
+            return *existing;
+        }
+        if (!slots && count < InlineCapacity) {
+            inlineKeys[count] = key;
+            return *new (&inlineValues()[count++]) V();
+        }
+        if (!slots || (count + 1) * 5 > capacity * 4) {
+            grow();
+        }
+        ++count;
+        return insertIntoTable(key, V());
+    }
+
+    // Calls f(symbol, value) for every entry
+    template <typename F>
+    void forEach(F f) const {
+        if (!slots) {
+            for (size_t i = 0; i < count; ++i) {
+                f(inlineKeys[i], inlineValues()[i]);
+            }
+            return;
+        }
+        for (size_t i = 0; i < capacity; ++i) {
+            if (slots[i].key) {
+                f(slots[i].key, slots[i].value());
+            }
+        }
+    }
+
+    template <typename F>
+    void forEach(F f) {
+        static_cast<const SymbolMap*>(this)->forEach(
+            [&f](Symbol key, const V& value) { f(key, const_cast<V&>(value)); });
+    }
+
+private:
+    struct Slot {
+        Symbol key = nullptr;
+        alignas(V) unsigned char storage[sizeof(V)];
+        V& value() { return *reinterpret_cast<V*>(storage); }
+        const V& value() const { return *reinterpret_cast<const V*>(storage); }
+    };
+
+    V* inlineValues() { return reinterpret_cast<V*>(inlineStorage); }
+    const V* inlineValues() const { return reinterpret_cast<const V*>(inlineStorage); }
+
+    size_t probeDistance(Symbol key, size_t pos) const {
+        return (pos - (key->hash & (capacity - 1))) & (capacity - 1);
+    }
+
+    // Places key with value, displacing residents that are closer to home
+    // than the carried entry; returns the value stored for key
+    V& insertIntoTable(Symbol key, V&& value) {
+        size_t mask = capacity - 1;
+        size_t pos = key->hash & mask;
+        size_t distance = 0;
+        Symbol carriedKey = key;
+        V carried(std::move(value));
+        V* result = nullptr;
+        for (;; ++distance, pos = (pos + 1) & mask) {
+            Slot& slot = slots[pos];
+            if (!slot.key) {
+                slot.key = carriedKey;
+                V* placed = new (slot.storage) V(std::move(carried));
+                return result ? *result : *placed;
+            }
+            size_t residentDistance = probeDistance(slot.key, pos);
+            if (residentDistance < distance) {
+                std::swap(carriedKey, slot.key);
+                std::swap(carried, slot.value());
+                if (!result) {
+                    result = &slot.value();
+                }
+                distance = residentDistance;
+            }
+        }
+    }
+
+    void grow() {
+        size_t oldCapacity = capacity;
+        Slot* oldSlots = slots;
+        capacity = oldSlots ? oldCapacity * 2 : InlineCapacity * 4;
+        slots = new Slot[capacity];
+        if (oldSlots) {
+            for (size_t i = 0; i < oldCapacity; ++i) {
+                if (oldSlots[i].key) {
+                    insertIntoTable(oldSlots[i].key, std::move(oldSlots[i].value()));
+                    oldSlots[i].value().~V();
+                }
+            }
+            delete[] oldSlots;
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                insertIntoTable(inlineKeys[i], std::move(inlineValues()[i]));
+                inlineValues()[i].~V();
+            }
+        }
+    }
+
+    void clear() {
+        if (slots) {
+            for (size_t i = 0; i < capacity; ++i) {
+                if (slots[i].key) {
+                    slots[i].value().~V();
+                }
+            }
+            delete[] slots;
+            slots = nullptr;
+            capacity = 0;
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                inlineValues()[i].~V();
+            }
+        }
+        count = 0;
+    }
+
+    size_t count = 0;
+    size_t capacity = 0;
+    Slot* slots = nullptr;
+    Symbol inlineKeys[InlineCapacity];
+    alignas(V) unsigned char inlineStorage[InlineCapacity * sizeof(V)];
+};
+
+#endif // SYMBOL_MAP_H
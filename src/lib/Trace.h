@@ -0,0 +1,102 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Chrome/Perfetto trace-event output (chrome://tracing, ui.perfetto.dev).
+// Events are recorded into a fixed ring of plain structs and only formatted as
+// JSON when the ring is full or the trace is closed, so recording a span costs
+// a clock read and a short copy.
+
+struct TraceEvent {
+    char phase;            // 'B' begin, 'E' end, 'i' instant
+    char name[48];
+    const char* category;
+    double timestamp;      // microseconds since the trace was opened
+    int line;              // source line, 0 when not applicable
+    int64_t value;         // extra numeric argument, -1 when not applicable
+};
+
+class Tracer {
+public:
+    static const size_t RingSize = 4096;
+
+    ~Tracer();
+
+    bool open(const std::string& path);
+    void close();
+
+    // Function call spans deeper than this are not recorded
+    void setMaxCallDepth(int depth) { maxCallDepth = depth; }
+
+    void begin(const char* category, const std::string& name, int line = 0);
+    void end(const char* category);
+    void instant(const char* category, const std::string& name, int64_t value = -1);
+
+    // Call spans honour the depth cap; the depth is tracked even when not recorded
+    bool enterCall();
+    void leaveCall();
+
+private:
+    TraceEvent& record(char phase, const char* category, const std::string& name);
+    void flush();
+
+    std::ofstream file;
+    TraceEvent ring[RingSize];
+    size_t used = 0;
+    bool firstEvent = true;
+    int maxCallDepth = 32;
+    int callDepth = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Set when --trace=FILE is given
+extern Tracer* tracer;
+
+// Records a begin event on construction and the matching end event when the
+// scope unwinds, including through runtime errors and return statements
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const std::string& name, int line = 0) : category(category) {
+        if (tracer) {
+            tracer->begin(category, name, line);
+        }
+    }
+    ~TraceSpan() {
+        if (tracer) {
+            tracer->end(category);
+        }
+    }
+
+private:
+    const char* category;
+};
+
+// Span for a script function call, subject to the call depth cap
+class TraceCallSpan {
+public:
+    TraceCallSpan(const std::string& name, int line) {
+        if (tracer) {
+            recorded = tracer->enterCall();
+            if (recorded) {
+                tracer->begin("call", name, line);
+            }
+        }
+    }
+    ~TraceCallSpan() {
+        if (tracer) {
+            if (recorded) {
+                tracer->end("call");
+            }
+            tracer->leaveCall();
+        }
+    }
+
+private:
+    bool recorded = false;
+};
+
+#endif // TRACE_H
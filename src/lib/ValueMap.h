@@ -0,0 +1,190 @@
+#ifndef VALUE_MAP_H
+#define VALUE_MAP_H
+
+#include "ScryptComponents.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Dictionary value of Scrypt ({key: value} literals). Entries are kept in a
+// dense vector in insertion order and found through an open-addressing index
+// of entry positions with linear probing, so lookups touch one small array and
+// iteration walks the entries in order. Removed entries leave a tombstone in
+// the index and a dead entry that the next rebuild drops.
+// Keys are numbers (other than NaN), booleans and strings, compared by type
+// and value.
+// Growing the map moves its values, so references returned by find() and
+// operator[] are only valid until the next insertion.
+
+class ValueMap {
+public:
+    static bool isKey(const Value& key) {
+        return key.getType() == Value::Type::Bool || key.getType() == Value::Type::String ||
+               (key.getType() == Value::Type::Double && key.asDouble() == key.asDouble());
+    }
+
+    size_t size() const { return liveCount; }
+
+    Value* find(const Value& key) {
+        int32_t slot = findSlot(key, hashKey(key));
+        return slot < 0 ? nullptr : &entries[index[slot]].value;
+    }
+
+    const Value* find(const Value& key) const { return const_cast<ValueMap*>(this)->find(key); }
+
+    // Value of key, inserting null when it is missing
+    Value& operator[](const Value& key) {
+        size_t hash = hashKey(key);
+        int32_t slot = findSlot(key, hash);
+        if (slot >= 0) {
+            return entries[index[slot]].value;
+        }
+        if ((entries.size() + 1) * 3 > index.size() * 2) {
+            rebuild(liveCount + 1);
+        }
+        size_t mask = index.size() - 1;
+        size_t pos = hash & mask;
+        while (index[pos] >= 0) {
+            pos = (pos + 1) & mask;
+        }
+        index[pos] = static_cast<int32_t>(entries.size());
+        entries.push_back({key, Value(), hash, true});
+        liveCount++;
+        return entries.back().value;
+    }
+
+    // Removes key, returning whether it was present
+    bool erase(const Value& key) {
+        int32_t slot = findSlot(key, hashKey(key));
+        if (slot < 0) {
+            return false;
+        }
+        Entry& entry = entries[index[slot]];
+        entry.live = false;
+        entry.key = Value();
+        entry.value = Value();
+        index[slot] = Deleted;
+        liveCount--;
+        return true;
+    }
+
+    // Calls f(key, value) for every entry in insertion order
+    template <typename F>
+    void forEach(F f) const {
+        for (const Entry& entry : entries) {
+            if (entry.live) {
+                f(entry.key, entry.value);
+            }
+        }
+    }
+
+    bool equals(const ValueMap& other) const {
+        if (size() != other.size()) {
+            return false;
+        }
+        for (const Entry& entry : entries) {
+            if (!entry.live) {
+                continue;
+            }
+            const Value* found = other.find(entry.key);
+            if (!found || !found->equals(entry.value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr int32_t Empty = -1;
+    static constexpr int32_t Deleted = -2;
+
+    struct Entry {
+        Value key;
+        Value value;
+        size_t hash;
+        bool live;
+    };
+
+    static size_t hashKey(const Value& key) {
+        uint64_t bits;
+        if (key.getType() == Value::Type::Bool) {
+            bits = key.asBool() ? 0x9e3779b97f4a7c15ULL : 0x7f4a7c159e3779b9ULL;
+        } else if (key.getType() == Value::Type::String) {
+            bits = key.asString()->hash();
+        } else {
+            double number = key.asDouble() == 0 ? 0.0 : key.asDouble();   // -0 and 0 are one key
+            std::memcpy(&bits, &number, sizeof bits);
+        }
+        // splitmix64 finalizer, so nearby numbers spread over the index
+        bits ^= bits >> 30;
+        bits *= 0xbf58476d1ce4e5b9ULL;
+        bits ^= bits >> 27;
+        bits *= 0x94d049bb133111ebULL;
+        bits ^= bits >> 31;
+        return static_cast<size_t>(bits);
+    }
+
+    static bool sameKey(const Value& a, const Value& b) {
+        if (a.getType() != b.getType()) {
+            return false;
+        }
+        switch (a.getType()) {
+            case Value::Type::Bool:
+                return a.asBool() == b.asBool();
+            case Value::Type::String:
+                return a.asString()->equals(*b.asString());
+            default:
+                return a.asDouble() == b.asDouble();
+        }
+    }
+
+    // Index slot holding key, or -1
+    int32_t findSlot(const Value& key, size_t hash) const {
+        if (index.empty()) {
+            return -1;
+        }
+        size_t mask = index.size() - 1;
+        for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+            int32_t position = index[pos];
+            if (position == Empty) {
+                return -1;
+            }
+            if (position >= 0 && entries[position].hash == hash && sameKey(entries[position].key, key)) {
+                return static_cast<int32_t>(pos);
+            }
+        }
+    }
+
+    // Drops dead entries and sizes the index for at least count entries
+    void rebuild(size_t count) {
+        if (liveCount != entries.size()) {
+            std::vector<Entry> live;
+            live.reserve(count);
+            for (Entry& entry : entries) {
+                if (entry.live) {
+                    live.push_back(std::move(entry));
+                }
+            }
+            entries.swap(live);
+        }
+        size_t capacity = 8;
+        while (count * 3 > capacity * 2) {
+            capacity *= 2;
+        }
+        index.assign(capacity, Empty);
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            size_t pos = entries[i].hash & mask;
+            while (index[pos] != Empty) {
+                pos = (pos + 1) & mask;
+            }
+            index[pos] = static_cast<int32_t>(i);
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::vector<int32_t> index;
+    size_t liveCount = 0;
+};
+
+#endif // VALUE_MAP_H
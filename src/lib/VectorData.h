@@ -0,0 +1,190 @@
+#ifndef VECTOR_DATA_H
+#define VECTOR_DATA_H
+
+#include "ScryptComponents.h"
+#include "Stats.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Storage of one persistent vector value. A vector never changes: assoc and
+// conj return a new vector that shares every part of the old one they do not
+// touch.
+// The elements live in leaves of up to 32 values under a tree of nodes with
+// up to 32 children each, indexed by five bits of the position per level, so
+// reaching an element or copying the path to it takes log32(n) steps. The
+// last, partly filled leaf is kept apart as the tail; appending copies only
+// the tail until it is full, and then moves it into the tree whole.
+
+class VectorData {
+public:
+    VectorData() : root(std::make_shared<Node>()) {}
+
+    // Vector of the given elements, built leaf by leaf
+    explicit VectorData(ArrayElements elements) : VectorData() {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        for (size_t begin = 0; begin < elements.size(); begin += Width) {
+            if (count > 0) {
+                pushTail();
+            }
+            size_t end = std::min(begin + Width, elements.size());
+            auto leaf = std::make_shared<Node>();
+            leaf->values.assign(elements.begin() + begin, elements.begin() + end);
+            tail = std::move(leaf);
+            count = end;
+        }
+    }
+
+    size_t size() const { return count; }
+
+    const Value& at(size_t i) const { return leafFor(i)[i & Mask]; }
+
+    // The leaf holding element i; it holds elements i - i % 32 onwards
+    const std::vector<Value>& leafFor(size_t i) const {
+        if (i >= tailOffset()) {
+            return tail->values;
+        }
+        const Node* node = root.get();
+        for (unsigned level = shift; level > 0; level -= Bits) {
+            node = node->children[(i >> level) & Mask].get();
+        }
+        return node->values;
+    }
+
+    // New vector with value appended
+    VectorData conj(Value value) const {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        VectorData result(*this);
+        auto leaf = std::make_shared<Node>();
+        if (count - tailOffset() < Width) {
+            leaf->values.reserve(count - tailOffset() + 1);
+            if (tail) {
+                leaf->values = tail->values;
+            }
+        } else {
+            result.pushTail();
+        }
+        leaf->values.push_back(std::move(value));
+        result.tail = std::move(leaf);
+        result.count = count + 1;
+        return result;
+    }
+
+    // New vector with element i replaced by value; i must be below size()
+    VectorData assoc(size_t i, Value value) const {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        VectorData result(*this);
+        if (i >= tailOffset()) {
+            auto leaf = std::make_shared<Node>(*tail);
+            leaf->values[i & Mask] = std::move(value);
+            result.tail = std::move(leaf);
+        } else {
+            result.root = assocPath(shift, *root, i, std::move(value));
+        }
+        return result;
+    }
+
+    bool equals(const VectorData& other) const {
+        if (count != other.count) {
+            return false;
+        }
+        if (root == other.root && tail == other.tail) {
+            return true;
+        }
+        for (size_t i = 0; i < count; i += Width) {
+            const std::vector<Value>& leaf = leafFor(i);
+            const std::vector<Value>& otherLeaf = other.leafFor(i);
+            if (&leaf == &otherLeaf) {
+                continue;
+            }
+            for (size_t j = 0; j < leaf.size(); ++j) {
+                if (!leaf[j].equals(otherLeaf[j])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr unsigned Bits = 5;
+    static constexpr size_t Width = size_t(1) << Bits;
+    static constexpr size_t Mask = Width - 1;
+
+    // A branch uses children and a leaf uses values. Nodes are never changed
+    // once they are reachable from a vector.
+    struct Node {
+        std::vector<std::shared_ptr<const Node>> children;
+        std::vector<Value> values;
+    };
+
+    // Position of the first element in the tail
+    size_t tailOffset() const { return count < Width ? 0 : ((count - 1) >> Bits) << Bits; }
+
+    // Moves the full tail into the tree, adding a level on top when the tree
+    // is full. Leaves tail and count for the caller to replace.
+    void pushTail() {
+        if ((count >> Bits) > (size_t(1) << shift)) {
+            auto newRoot = std::make_shared<Node>();
+            newRoot->children.push_back(root);
+            newRoot->children.push_back(pathTo(shift, tail));
+            root = std::move(newRoot);
+            shift += Bits;
+        } else {
+            root = pushLeaf(shift, *root, tail);
+        }
+    }
+
+    // Copy of parent, a node at level, with leaf added after its last element
+    std::shared_ptr<const Node> pushLeaf(unsigned level, const Node& parent,
+                                         const std::shared_ptr<const Node>& leaf) const {
+        auto copy = std::make_shared<Node>(parent);
+        size_t child = ((count - 1) >> level) & Mask;
+        std::shared_ptr<const Node> inserted;
+        if (level == Bits) {
+            inserted = leaf;
+        } else if (child < parent.children.size()) {
+            inserted = pushLeaf(level - Bits, *parent.children[child], leaf);
+        } else {
+            inserted = pathTo(level - Bits, leaf);
+        }
+        if (child < copy->children.size()) {
+            copy->children[child] = std::move(inserted);
+        } else {
+            copy->children.push_back(std::move(inserted));
+        }
+        return copy;
+    }
+
+    // Chain of single-child branches from level down to leaf
+    static std::shared_ptr<const Node> pathTo(unsigned level, std::shared_ptr<const Node> leaf) {
+        while (level > 0) {
+            auto branch = std::make_shared<Node>();
+            branch->children.push_back(std::move(leaf));
+            leaf = std::move(branch);
+            level -= Bits;
+        }
+        return leaf;
+    }
+
+    // Copy of node, at level, with element i replaced; the path down to i is
+    // copied and everything else shared
+    static std::shared_ptr<const Node> assocPath(unsigned level, const Node& node, size_t i, Value value) {
+        auto copy = std::make_shared<Node>(node);
+        if (level == 0) {
+            copy->values[i & Mask] = std::move(value);
+        } else {
+            size_t child = (i >> level) & Mask;
+            copy->children[child] = assocPath(level - Bits, *node.children[child], i, std::move(value));
+        }
+        return copy;
+    }
+
+    std::shared_ptr<const Node> root;
+    std::shared_ptr<const Node> tail;
+    size_t count = 0;
+    unsigned shift = Bits;
+};
+
+#endif // VECTOR_DATA_H
@@ -0,0 +1,77 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for the parallel builtins (psort, pscan). Every thread of the
+// pool has its own task queue. parallelFor deals its tasks out over the
+// queues; each thread takes work from the back of its own queue and, once
+// that is empty, steals from the front of the others', so uneven tasks still
+// keep every thread busy. The calling thread works through tasks as well
+// while it waits.
+// Tasks must not allocate through the heap profiler or write to the tracer,
+// which are not thread-safe; the builtins only run arithmetic and std::sort
+// on buffers prepared beforehand.
+
+class WorkPool {
+public:
+    // The pool shared by the builtins, started on first use
+    static WorkPool& shared();
+    // Threads of the shared pool, counting the calling thread. 0, the default,
+    // uses one per hardware thread. Only takes effect before first use.
+    static void setDefaultThreads(unsigned threads);
+
+    explicit WorkPool(unsigned threads);
+    ~WorkPool();
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Calls body(i) for every i below count and returns once all calls have
+    // finished. If calls throw, the first exception is rethrown afterwards.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+private:
+    struct Job {
+        const std::function<void(size_t)>* body;
+        std::atomic<size_t> remaining;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        Job* job;
+        size_t index;
+    };
+
+    // Tasks are taken from the back by the owner and from the front by
+    // thieves. The vector only grows on the thread calling parallelFor.
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        size_t head = 0;
+    };
+
+    void workerLoop(size_t home);
+    bool runOne(size_t home);
+    static void run(const Task& task);
+
+    // Queue 0 belongs to threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queuedTasks{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+#endif // WORK_POOL_H
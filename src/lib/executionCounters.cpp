@@ -0,0 +1,138 @@
+#include "ExecutionCounters.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+// Finds or creates the counter record for the node's source position
+NodeCounts& ExecutionCounters::entry(const ASTNode* node) {
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(node->line)) << 32) |
+                   static_cast<uint32_t>(node->column);
+    auto it = counts.find(key);
+    if (it == counts.end()) {
+        it = counts.emplace(key, NodeCounts(node->getType(), node->line, node->column)).first;
+    }
+    return it->second;
+}
+
+void ExecutionCounters::countStatement(const ASTNode* node) {
+    entry(node).executions++;
+}
+
+void ExecutionCounters::countBranch(const IfNode* node, bool taken) {
+    NodeCounts& record = entry(node);
+    if (taken) {
+        record.taken++;
+    } else {
+        record.notTaken++;
+    }
+}
+
+void ExecutionCounters::countIteration(const WhileNode* node) {
+    entry(node).iterations++;
+}
+
+void ExecutionCounters::countCall(const FunctionNode* node) {
+    entry(node).calls++;
+}
+
+std::vector<NodeCounts> ExecutionCounters::sorted() const {
+    std::vector<NodeCounts> result;
+    result.reserve(counts.size());
+    for (const auto& count : counts) {
+        result.push_back(count.second);
+    }
+    std::sort(result.begin(), result.end(), [](const NodeCounts& a, const NodeCounts& b) {
+        return a.line != b.line ? a.line < b.line : a.column < b.column;
+    });
+    return result;
+}
+
+// Short description of the branch/loop/call counters of a node
+static std::string describe(const NodeCounts& counts) {
+    std::ostringstream out;
+    if (counts.type == ASTNode::Type::IfNode) {
+        out << "taken " << counts.taken << ", not taken " << counts.notTaken;
+    } else if (counts.type == ASTNode::Type::WhileNode) {
+        out << "iterations " << counts.iterations;
+    } else if (counts.type == ASTNode::Type::FunctionNode) {
+        out << "calls " << counts.calls;
+    }
+    return out.str();
+}
+
+void ExecutionCounters::writeAnnotatedSource(std::ostream& os, const std::string& source) const {
+    std::vector<NodeCounts> nodes = sorted();
+    size_t next = 0;
+    std::istringstream input(source);
+    std::string text;
+    int lineNumber = 0;
+
+    os << "Execution counts" << std::endl;
+    while (std::getline(input, text)) {
+        lineNumber++;
+        uint64_t executions = 0;
+        bool executed = false;
+        std::string notes;
+        while (next < nodes.size() && nodes[next].line <= lineNumber) {
+            if (nodes[next].line == lineNumber) {
+                executions = std::max(executions, nodes[next].executions);
+                executed = true;
+                std::string note = describe(nodes[next]);
+                if (!note.empty()) {
+                    notes += (notes.empty() ? "" : "; ") + note;
+                }
+            }
+            next++;
+        }
+        os << std::setw(10);
+        if (executed) {
+            os << executions;
+        } else {
+            os << "";
+        }
+        os << std::setw(6) << lineNumber << "  " << text;
+        if (!notes.empty()) {
+            os << "    // " << notes;
+        }
+        os << std::endl;
+    }
+
+    // Hot spots are ranked on the largest of the node's counters
+    auto weight = [](const NodeCounts& counts) {
+        return std::max({counts.executions, counts.iterations, counts.calls});
+    };
+    std::stable_sort(nodes.begin(), nodes.end(), [&](const NodeCounts& a, const NodeCounts& b) {
+        return weight(a) > weight(b);
+    });
+    os << std::endl << "Hot spots" << std::endl;
+    for (size_t i = 0; i < nodes.size() && i < 10; ++i) {
+        os << std::setw(10) << weight(nodes[i]) << "  line " << nodes[i].line
+           << " column " << nodes[i].column << "  " << nodeTypeName(nodes[i].type);
+        std::string note = describe(nodes[i]);
+        if (!note.empty()) {
+            os << " (" << note << ")";
+        }
+        os << std::endl;
+    }
+}
+
+void ExecutionCounters::writeJson(std::ostream& os) const {
+    std::vector<NodeCounts> nodes = sorted();
+    os << "{\"nodes\": [";
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const NodeCounts& counts = nodes[i];
+        os << (i > 0 ? "," : "") << "\n  {\"line\": " << counts.line
+           << ", \"column\": " << counts.column
+           << ", \"kind\": \"" << nodeTypeName(counts.type) << "\""
+           << ", \"executions\": " << counts.executions;
+        if (counts.type == ASTNode::Type::IfNode) {
+            os << ", \"taken\": " << counts.taken << ", \"notTaken\": " << counts.notTaken;
+        } else if (counts.type == ASTNode::Type::WhileNode) {
+            os << ", \"iterations\": " << counts.iterations;
+        } else if (counts.type == ASTNode::Type::FunctionNode) {
+            os << ", \"calls\": " << counts.calls;
+        }
+        os << "}";
+    }
+    os << "\n]}" << std::endl;
+}
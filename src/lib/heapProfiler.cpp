@@ -0,0 +1,161 @@
+#include "HeapProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+HeapProfiler* heapProfiler = nullptr;
+
+HeapProfiler::HeapProfiler(uint64_t sampleBytes) : sampleBytes(sampleBytes ? sampleBytes : 1) {}
+
+HeapProfiler::~HeapProfiler() {
+    stop();
+}
+
+void HeapProfiler::start() {
+    heapProfiler = this;
+    running = true;
+    setAllocationSampler(sample, release, sampleBytes);
+}
+
+void HeapProfiler::stop() {
+    if (!running) {
+        return;
+    }
+    setAllocationSampler(nullptr, nullptr, sampleBytes);
+    running = false;
+    if (heapProfiler == this) {
+        heapProfiler = nullptr;
+    }
+}
+
+double HeapProfiler::weight(uint64_t size) const {
+    double ratio = static_cast<double>(size) / sampleBytes;
+    return static_cast<double>(size) / -std::expm1(-ratio);
+}
+
+// Site of the current line and call stack, created on first use
+uint32_t HeapProfiler::currentSite(HeapCategory category) {
+    Stack stack;
+    stack.reserve(frames.size());
+    for (const Frame& frame : frames) {
+        stack.emplace_back(*frame.name, frame.line);
+    }
+    auto found = stackIds.find(stack);
+    size_t stackId;
+    if (found == stackIds.end()) {
+        stackId = stacks.size();
+        stacks.push_back(stack);
+        stackIds.emplace(std::move(stack), stackId);
+    } else {
+        stackId = found->second;
+    }
+    auto key = std::make_tuple(static_cast<int>(category), currentLine, stackId);
+    auto site = siteIds.find(key);
+    if (site != siteIds.end()) {
+        return site->second;
+    }
+    Site created;
+    created.category = category;
+    created.line = currentLine;
+    created.stack = stackId;
+    sites.push_back(created);
+    uint32_t id = static_cast<uint32_t>(sites.size());
+    siteIds.emplace(key, id);
+    return id;
+}
+
+uint32_t HeapProfiler::sample(HeapCategory category, uint64_t size) {
+    HeapProfiler* profiler = heapProfiler;
+    if (!profiler) {
+        return 0;
+    }
+    uint32_t id = profiler->currentSite(category);
+    Site& site = profiler->sites[id - 1];
+    double bytes = profiler->weight(size);
+    site.totalBytes += bytes;
+    site.liveBytes += bytes;
+    site.samples++;
+    return id;
+}
+
+void HeapProfiler::release(uint32_t id, uint64_t size) {
+    HeapProfiler* profiler = heapProfiler;
+    if (profiler && id <= profiler->sites.size()) {
+        profiler->sites[id - 1].liveBytes -= profiler->weight(size);
+    }
+}
+
+void HeapProfiler::snapshotLive() {
+    for (Site& site : sites) {
+        site.liveAtEnd = site.liveBytes;
+    }
+    snapshotTaken = true;
+}
+
+static std::string formatBytes(double bytes) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    if (bytes >= 1024.0 * 1024.0) {
+        text << bytes / (1024.0 * 1024.0) << " MB";
+    } else {
+        text << bytes / 1024.0 << " KB";
+    }
+    return text.str();
+}
+
+// One row per site, largest live size first, in the spirit of the text output
+// of native heap profilers
+void HeapProfiler::writeReport(std::ostream& os, const std::string& source) const {
+    std::vector<std::string> lines;
+    std::istringstream input(source);
+    for (std::string line; std::getline(input, line);) {
+        size_t start = line.find_first_not_of(" \t");
+        lines.push_back(start == std::string::npos ? "" : line.substr(start));
+    }
+
+    std::vector<const Site*> order;
+    double totalLive = 0;
+    double totalBytes = 0;
+    uint64_t samples = 0;
+    for (const Site& site : sites) {
+        order.push_back(&site);
+        totalLive += snapshotTaken ? site.liveAtEnd : site.liveBytes;
+        totalBytes += site.totalBytes;
+        samples += site.samples;
+    }
+    auto live = [this](const Site* site) { return snapshotTaken ? site->liveAtEnd : site->liveBytes; };
+    std::sort(order.begin(), order.end(), [&live](const Site* a, const Site* b) {
+        return live(a) != live(b) ? live(a) > live(b) : a->totalBytes > b->totalBytes;
+    });
+
+    os << "Heap profile: " << samples << " samples, one per " << sampleBytes << " allocated bytes on average" << std::endl
+       << "Estimated " << formatBytes(totalLive) << " live at the end of the program, "
+       << formatBytes(totalBytes) << " allocated in total" << std::endl << std::endl
+       << std::setw(10) << "live" << std::setw(7) << "live%" << std::setw(11) << "total" << std::setw(8) << "total%"
+       << "  " << std::left << std::setw(9) << "category" << std::right << std::setw(5) << "line" << "  source"
+       << std::endl;
+    std::ios::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(1);
+    for (const Site* site : order) {
+        os << std::setw(10) << formatBytes(live(site)) << std::setw(6) << (totalLive > 0 ? 100 * live(site) / totalLive : 0)
+           << "%" << std::setw(11) << formatBytes(site->totalBytes) << std::setw(7)
+           << (totalBytes > 0 ? 100 * site->totalBytes / totalBytes : 0) << "%  " << std::left << std::setw(9)
+           << heapCategoryName(site->category) << std::right << std::setw(5) << site->line << "  ";
+        if (site->line > 0 && site->line <= static_cast<int>(lines.size())) {
+            os << lines[site->line - 1];
+        } else {
+            os << "(not inside a statement)";
+        }
+        os << std::endl;
+        const Stack& stack = stacks[site->stack];
+        if (!stack.empty()) {
+            os << std::setw(54) << "" << "in ";
+            for (size_t i = stack.size(); i-- > 0;) {
+                os << stack[i].first << " (called at line " << stack[i].second << ")" << (i > 0 ? " <- " : "");
+            }
+            os << std::endl;
+        }
+    }
+    os.flags(flags);
+}
@@ -0,0 +1,1999 @@
+#include "Interpreter.h"
+#include "mParser.h"
+#include "lex.h"
+#include "ExecutionCounters.h"
+#include "HeapProfiler.h"
+#include "MatrixData.h"
+#include "RecordData.h"
+#include "VectorData.h"
+#include "RunArena.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "ValueMap.h"
+#include "WorkPool.h"
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+
+// Set when --counts or --counts-json is given
+ExecutionCounters* executionCounters = nullptr;
+
+std::ostream* scriptOutput = &std::cout;
+
+// True when evaluating node cannot assign, call a function or print, so a
+// value borrowed before evaluating it is still where it was afterwards
+static bool isPure(const ASTNode* node) {
+    switch (node->getType()) {
+        case ASTNode::Type::NumberNode:
+        case ASTNode::Type::BooleanNode:
+        case ASTNode::Type::NullNode:
+        case ASTNode::Type::StringNode:
+        case ASTNode::Type::VariableNode:
+            return true;
+        case ASTNode::Type::BinaryOpNode: {
+            auto binaryOpNode = static_cast<const BinaryOpNode*>(node);
+            return binaryOpNode->op.type != TokenType::ASSIGN && isPure(binaryOpNode->left.get()) &&
+                   isPure(binaryOpNode->right.get());
+        }
+        case ASTNode::Type::ArrayLookupNode: {
+            auto arrayLookupNode = static_cast<const ArrayLookupNode*>(node);
+            return isPure(arrayLookupNode->array.get()) && isPure(arrayLookupNode->index.get());
+        }
+        case ASTNode::Type::SliceNode: {
+            auto sliceNode = static_cast<const SliceNode*>(node);
+            return isPure(sliceNode->array.get()) && (!sliceNode->begin || isPure(sliceNode->begin.get())) &&
+                   (!sliceNode->end || isPure(sliceNode->end.get()));
+        }
+        case ASTNode::Type::FieldNode:
+            return isPure(static_cast<const FieldNode*>(node)->record.get());
+        default:
+            return false;
+    }
+}
+
+// Position indexValue refers to in a sequence of size elements, with the
+// runtime errors of a[i]
+static size_t checkedIndex(const Value& indexValue, size_t size) {
+    if (indexValue.getType() != Value::Type::Double) {
+        throw std::runtime_error("Runtime error: index is not a number.");
+    }
+
+    double intPart;
+    if (modf(indexValue.asDouble(), &intPart) != 0.0) {
+        throw std::runtime_error("Runtime error: index is not an integer.");
+    }
+
+    int index = static_cast<int>(intPart);
+    if (index < 0 || index >= static_cast<int>(size)) {
+        throw std::runtime_error("Runtime error: index out of bounds.");
+    }
+    return static_cast<size_t>(index);
+}
+
+// Position indexValue refers to in arrayValue, with the runtime errors of a[i]
+static size_t elementIndex(const Value& arrayValue, const Value& indexValue) {
+    return checkedIndex(indexValue, arrayValue.asArray().size());
+}
+
+// s[i]: the one-character string at indexValue
+static Value characterAt(const Value& stringValue, const Value& indexValue) {
+    const StringPtr& string = stringValue.asString();
+    size_t index = checkedIndex(indexValue, string->size());
+    return Value(StringData::make(std::string(1, string->text()[index])));
+}
+
+// v[i]: the element of a persistent vector, with the runtime errors of a[i]
+static const Value& vectorElement(const Value& vectorValue, const Value& indexValue) {
+    const VectorData& vector = vectorValue.asVector();
+    return vector.at(checkedIndex(indexValue, vector.size()));
+}
+
+// Slot of the field a FieldNode names in record, with the runtime error of
+// p.x. The slot found is kept in the node as the guess for next time.
+static size_t fieldSlot(const RecordData& record, const FieldNode* fieldNode) {
+    size_t slot = fieldNode->slot;
+    if (!record.findSlot(fieldNode->fieldSymbol, slot)) {
+        throw std::runtime_error("Runtime error: unknown field " + fieldNode->field.value);
+    }
+    fieldNode->slot = slot;
+    return slot;
+}
+
+// m[i][j]: the element of a matrix at a row and a column
+static Value matrixElement(const Value& matrixValue, const Value& rowIndex, const Value& columnIndex) {
+    const MatrixData& matrix = matrixValue.asMatrix();
+    size_t row = checkedIndex(rowIndex, matrix.rows());
+    return Value(matrix.row(row)[checkedIndex(columnIndex, matrix.columns())]);
+}
+
+// m[i]: new array holding a row of a matrix
+static Value matrixRow(const Value& matrixValue, const Value& indexValue) {
+    const MatrixData& matrix = matrixValue.asMatrix();
+    const double* row = matrix.row(checkedIndex(indexValue, matrix.rows()));
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> elements;
+    elements.reserve(matrix.columns());
+    for (size_t j = 0; j < matrix.columns(); ++j) {
+        elements.push_back(Value(row[j]));
+    }
+    return Value(std::move(elements));
+}
+
+// Bound of a slice of a sequence of size elements: an integer from 0 to size
+static size_t sliceBound(const Value& boundValue, size_t size) {
+    return boundValue.isInteger() && boundValue.asDouble() == static_cast<double>(size)
+        ? size
+        : checkedIndex(boundValue, size);
+}
+
+// sequence[begin:end] for an array or a string; a null bound is omitted. An
+// array slice views the array's elements instead of copying them.
+static Value sliceValue(const Value& sequence, const Value* beginValue, const Value* endValue) {
+    if (!sequence.isArray() && !sequence.isString()) {
+        throw std::runtime_error("Runtime error: not an array.");
+    }
+    size_t size = sequence.isArray() ? sequence.asArray().size() : sequence.asString()->size();
+    size_t begin = beginValue ? sliceBound(*beginValue, size) : 0;
+    size_t end = endValue ? sliceBound(*endValue, size) : size;
+    if (begin > end) {
+        throw std::runtime_error("Runtime error: index out of bounds.");
+    }
+    if (sequence.isString()) {
+        return Value(StringData::make(sequence.asString()->text().substr(begin, end - begin)));
+    }
+    return sequence.sliceArray(begin, end);
+}
+
+// The text an operand of string concatenation stands for
+static StringPtr concatOperand(const Value& value) {
+    switch (value.getType()) {
+        case Value::Type::String:
+            return value.asString();
+        case Value::Type::Double:
+        case Value::Type::Bool:
+        case Value::Type::Null: {
+            std::ostringstream text;
+            printValue(text, value);
+            return StringData::make(text.str());
+        }
+        default:
+            throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+}
+
+// Three-way comparison of two strings, for < <= > >=
+static int compareStrings(const Value& left, const Value& right) {
+    if (!left.isString() || !right.isString()) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    return left.asString()->compare(*right.asString());
+}
+
+// Checks that key can index a map, with the runtime error of m[k]
+static void checkMapKey(const Value& key) {
+    if (!ValueMap::isKey(key)) {
+        throw std::runtime_error("Runtime error: invalid map key.");
+    }
+}
+
+// Value stored under key in mapValue, with the runtime errors of m[k]
+static const Value& mapEntry(const Value& mapValue, const Value& key) {
+    checkMapKey(key);
+    const Value* found = mapValue.asMap().find(key);
+    if (!found) {
+        throw std::runtime_error("Runtime error: key not found.");
+    }
+    return *found;
+}
+
+// The stored value a variable or element expression names, without copying
+// it, or nullptr when the expression has to be evaluated into a new value.
+// Assignments can move the variables of a scope, so the pointer is only good
+// until the next one.
+static const Value* borrowValue(const ASTNode* node, const std::shared_ptr<Scope>& currentScope) {
+    if (node->getType() == ASTNode::Type::VariableNode) {
+        return currentScope->getVariable(static_cast<const VariableNode*>(node)->symbol);
+    }
+    if (node->getType() == ASTNode::Type::ArrayLookupNode) {
+        auto arrayLookupNode = static_cast<const ArrayLookupNode*>(node);
+        if (!isPure(arrayLookupNode->index.get())) {
+            return nullptr;
+        }
+        const Value* arrayValue = borrowValue(arrayLookupNode->array.get(), currentScope);
+        if (!arrayValue || (!arrayValue->isArray() && !arrayValue->isMap() && !arrayValue->isVector())) {
+            return nullptr;
+        }
+        Value indexValue = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+        if (arrayValue->isMap()) {
+            return &mapEntry(*arrayValue, indexValue);
+        }
+        if (arrayValue->isVector()) {
+            return &vectorElement(*arrayValue, indexValue);
+        }
+        return &arrayValue->asArray()[elementIndex(*arrayValue, indexValue)];
+    }
+    if (node->getType() == ASTNode::Type::FieldNode) {
+        auto fieldNode = static_cast<const FieldNode*>(node);
+        const Value* recordValue = borrowValue(fieldNode->record.get(), currentScope);
+        if (!recordValue || !recordValue->isRecord()) {
+            return nullptr;
+        }
+        const RecordData& record = recordValue->asRecord();
+        return &record.slot(fieldSlot(record, fieldNode));
+    }
+    return nullptr;
+}
+
+// An evaluated operand: borrowed from where it is stored when allowed and
+// possible, otherwise the computed value
+class Operand {
+public:
+    Operand(const ASTNode* node, const std::shared_ptr<Scope>& currentScope, bool borrow)
+        : borrowed(borrow ? borrowValue(node, currentScope) : nullptr) {
+        if (!borrowed) {
+            owned = evaluateExpression(node, currentScope);
+        }
+    }
+
+    const Value& get() const { return borrowed ? *borrowed : owned; }
+
+private:
+    const Value* borrowed;
+    Value owned;
+};
+
+// Checks for Boolean True and False
+Value tokenToValue(const Token& token) {
+    switch (token.type) {
+        case TokenType::NUMBER:
+            return Value(std::stod(token.value));
+        case TokenType::BOOLEAN_TRUE:
+            return Value(true);
+        case TokenType::BOOLEAN_FALSE:
+            return Value(false);
+        default:
+            throw std::runtime_error("Invalid token type for value conversion");
+    }
+}
+
+
+// Evaluate the block node
+void evaluateBlock(const BlockNode* blockNode, const std::shared_ptr<Scope>& currentScope) {
+    if (!blockNode) {
+        throw std::runtime_error("Null block node passed to evaluateBlock");
+    }
+
+    try {
+        for (const auto& stmt : blockNode->statements) {
+            evaluateStatement(stmt.get(), currentScope);
+        }
+    } catch (...) {
+        throw;
+    }
+}
+
+
+// Evaluate the top level statements, each one as its own trace span
+void evaluateProgram(const BlockNode* program, const std::shared_ptr<Scope>& currentScope) {
+    if (!tracer) {
+        evaluateBlock(program, currentScope);
+        return;
+    }
+    for (const auto& stmt : program->statements) {
+        TraceSpan span("statement", nodeTypeName(stmt->getType()), stmt->line);
+        evaluateStatement(stmt.get(), currentScope);
+    }
+}
+
+
+// Arguments of the calls in progress on this thread. The stack is a list of
+// chunks that are never moved or freed, and each call's arguments are placed
+// together in one chunk, so an Arguments window stays valid for the whole call
+// even when the callee makes more calls. Slots above the top keep their storage
+// but are reset to null, so the stack holds no references once a call has
+// returned.
+namespace {
+
+struct ArgumentChunk {
+    std::unique_ptr<Value[]> values;
+    size_t capacity;
+};
+
+// Values in the first chunk; each new chunk is twice as large up to the
+// largest size, and a call with more arguments gets a chunk of its own size
+const size_t FirstArgumentChunkSize = 16;
+const size_t LargestArgumentChunkSize = 1024;
+
+thread_local std::vector<ArgumentChunk> argumentChunks;
+thread_local size_t argumentChunk = 0;
+thread_local size_t argumentTop = 0;
+
+// The arguments of one call, popped when the call finishes or throws
+class ArgumentFrame {
+public:
+    explicit ArgumentFrame(size_t count) : chunk(argumentChunk), top(argumentTop) {
+        if (argumentChunks.empty() || argumentTop + count > argumentChunks[argumentChunk].capacity) {
+            size_t next = argumentChunks.empty() ? 0 : argumentChunk + 1;
+            if (next == argumentChunks.size() || argumentChunks[next].capacity < count) {
+                HeapCategoryScope heap(HeapCategory::Values);
+                size_t size = FirstArgumentChunkSize;
+                if (next > 0) {
+                    size = std::min(argumentChunks[next - 1].capacity * 2, LargestArgumentChunkSize);
+                }
+                size = std::max(size, count);
+                argumentChunks.insert(argumentChunks.begin() + next,
+                                      ArgumentChunk{std::unique_ptr<Value[]>(new Value[size]), size});
+            }
+            argumentChunk = next;
+            argumentTop = 0;
+        }
+        values = argumentChunks[argumentChunk].values.get() + argumentTop;
+        argumentTop += count;
+    }
+    ~ArgumentFrame() {
+        while (pushed > 0) {
+            values[--pushed] = Value();
+        }
+        argumentChunk = chunk;
+        argumentTop = top;
+    }
+    ArgumentFrame(const ArgumentFrame&) = delete;
+    ArgumentFrame& operator=(const ArgumentFrame&) = delete;
+
+    void push(Value&& argument) {
+        values[pushed++] = std::move(argument);
+    }
+
+    Arguments arguments() const { return Arguments(values, pushed); }
+
+private:
+    size_t chunk;
+    size_t top;
+    Value* values;
+    size_t pushed = 0;
+};
+
+}
+
+// Evaluate function calls
+Value evaluateFunctionCall(const CallNode* node, const std::shared_ptr<Scope>& currentScope) {
+try{
+    const std::string& functionName = static_cast<const VariableNode*>(node->callee.get())->identifier.value;
+    ArgumentFrame frame(node->arguments.size());
+    for (const auto& arg : node->arguments) {
+        frame.push(evaluateExpression(arg.get(), currentScope));
+    }
+    Arguments args = frame.arguments();
+    if (functionName == "push") {
+        return pushFunction(args);
+    } else if (functionName == "pop") {
+        return popFunction(args);
+    } else if (functionName == "len") {
+        return lenFunction(args);
+    } else {
+        auto callee = static_cast<const VariableNode*>(node->callee.get());
+        if (!currentScope->getVariable(callee->symbol)) {
+            if (Builtin builtin = findBuiltin(callee->symbol)) {
+                return builtin(args);
+            }
+        }
+        auto funcValue = evaluateExpression(node->callee.get(), currentScope);
+        return callFunction(funcValue, args, node->line);
+    }
+} catch (...) {
+    throw;
+}
+}
+
+// Calls a script function with args, which are moved into its scope. line is
+// the call site, for traces and heap profiles.
+Value callFunction(const Value& funcValue, Arguments args, int line) {
+    if (funcValue.getType() == Value::Type::BuiltinFunction) {
+        // Native function values, such as struct constructors, take their
+        // arguments as a vector
+        std::vector<Value> arguments;
+        {
+            HeapCategoryScope heap(HeapCategory::Arrays);
+            arguments.reserve(args.size());
+            for (size_t i = 0; i < args.size(); ++i) {
+                arguments.push_back(std::move(args[i]));
+            }
+        }
+        return funcValue.executeFunction(arguments);
+    }
+    if (funcValue.getType() != Value::Type::Function) {
+        throw std::runtime_error("Runtime error: not a function.");
+    }
+
+    const auto& function = funcValue.asFunction();
+    auto callScope = function.capturedScope;
+
+    const auto& params = function.definition->parameters;
+    if (params.size() != args.size()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    if (executionCounters) {
+        executionCounters->countCall(function.definition.get());
+    }
+    TraceCallSpan span(function.definition->name.value, line);
+    FunctionCounters counters(function.definition->name.value);
+    HeapProfileCall heapCall(function.definition->name.value, line);
+
+    for (size_t i = 0; i < params.size(); ++i) {
+        callScope->setVariable(function.definition->parameterSymbols[i], std::move(args[i]));
+    }
+    
+    try {
+        evaluateBlock(static_cast<const BlockNode*>(function.definition->body.get()), callScope);
+    } catch (ReturnException& e) {
+        return std::move(e.getValue());
+    }
+
+    return Value();
+}
+
+
+
+// Evaluate Function Definitions
+void evaluateFunctionDefinition(const FunctionNode* functionNode, const std::shared_ptr<Scope>& currentScope) {
+    if (!functionNode) {
+        throw std::runtime_error("Null function node passed to evaluateFunctionDefinition");
+    }
+
+    try {
+        Value::Function functionValue;
+        {
+            HeapCategoryScope heap(HeapCategory::Closures);
+            functionValue.definition = std::make_unique<FunctionNode>(*functionNode);
+            functionValue.capturedScope = currentScope->copyScope();
+        }
+        Value value(std::move(functionValue));
+        currentScope->setVariable(functionNode->nameSymbol, std::move(value));
+    } catch (...) {
+        throw;
+    }
+}
+
+
+// Evaluate struct declarations: binds the name to a constructor that takes
+// one value per field, copied as in an array literal. Every evaluation of a
+// declaration shares the node's layout, so its records stay comparable.
+void evaluateStructDefinition(const StructNode* structNode, const std::shared_ptr<Scope>& currentScope) {
+    std::shared_ptr<const RecordLayout> layout = structNode->layout;
+    Value constructor(Value::FunctionPtr([layout](std::vector<Value>& args) {
+        if (args.size() != layout->fields.size()) {
+            throw std::runtime_error("Runtime error: incorrect argument count.");
+        }
+        for (Value& arg : args) {
+            arg = arg.deepCopy();
+        }
+        return Value(RecordData(layout, std::move(args)));
+    }));
+    currentScope->setVariable(structNode->nameSymbol, std::move(constructor));
+}
+
+// Evaluate Statements
+void evaluateStatement(const ASTNode* stmt, const std::shared_ptr<Scope>& currentScope) {
+    try{
+    if (executionCounters) {
+        executionCounters->countStatement(stmt);
+    }
+    HeapProfileLine heapLine(stmt->line);
+    switch (stmt->getType()) {
+        case ASTNode::Type::IfNode:
+            evaluateIf(static_cast<const IfNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::WhileNode:
+            evaluateWhile(static_cast<const WhileNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::PrintNode:
+            evaluatePrint(static_cast<const PrintNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::AssignmentNode:
+            evaluateAssignment(static_cast<const AssignmentNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::BlockNode:
+            evaluateBlock(static_cast<const BlockNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::FunctionNode:
+            evaluateFunctionDefinition(static_cast<const FunctionNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::StructNode:
+            evaluateStructDefinition(static_cast<const StructNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::ReturnNode:
+            evaluateReturn(static_cast<const ReturnNode*>(stmt), currentScope);
+            break;
+        case ASTNode::Type::CallNode:
+            evaluateFunctionCall(static_cast<const CallNode*>(stmt), currentScope);
+            break;
+        default:
+            throw std::runtime_error("Unknown Node Type in evaluateStatement");
+    }
+} catch (...) {
+    throw;
+}
+}
+
+// Evaluate Expressions
+Value evaluateExpression(const ASTNode* node, const std::shared_ptr<Scope>& currentScope) {
+    if (!node) {
+        throw std::runtime_error("Null expression node");
+    }
+    try {
+        switch (node->getType()) {
+            case ASTNode::Type::NumberNode: {
+                auto numberNode = static_cast<const NumberNode*>(node);
+                return Value(std::stod(numberNode->value.value));
+            }
+            case ASTNode::Type::BooleanNode: {
+                auto booleanNode = static_cast<const BooleanNode*>(node);
+                return Value(booleanNode->value.type == TokenType::BOOLEAN_TRUE);
+            }
+            case ASTNode::Type::StringNode: {
+                auto stringNode = static_cast<const StringNode*>(node);
+                if (!stringNode->text) {
+                    stringNode->text = StringData::intern(stringNode->value.value);
+                }
+                return Value(stringNode->text);
+            }
+            case ASTNode::Type::VariableNode: {
+                auto variableNode = static_cast<const VariableNode*>(node);
+                return evaluateVariable(variableNode, currentScope);
+            }
+            case ASTNode::Type::BinaryOpNode: {
+                auto binaryOpNode = static_cast<const BinaryOpNode*>(node);
+                return evaluateBinaryOperation(binaryOpNode, currentScope);
+            }
+            case ASTNode::Type::AssignmentNode: {
+                auto assignmentNode = static_cast<const AssignmentNode*>(node);
+                return evaluateAssignment(assignmentNode, currentScope);
+            }
+            case ASTNode::Type::CallNode: {
+                auto callNode = static_cast<const CallNode*>(node);
+                return evaluateFunctionCall(callNode, currentScope);
+            }
+            case ASTNode::Type::ArrayLiteralNode:
+                return evaluateArrayLiteralNode(static_cast<const ArrayLiteralNode*>(node), currentScope);
+            case ASTNode::Type::ArrayLookupNode:
+                return evaluateArrayLookupNode(static_cast<const ArrayLookupNode*>(node), currentScope);
+            case ASTNode::Type::MapLiteralNode:
+                return evaluateMapLiteralNode(static_cast<const MapLiteralNode*>(node), currentScope);
+            case ASTNode::Type::SliceNode:
+                return evaluateSliceNode(static_cast<const SliceNode*>(node), currentScope);
+            case ASTNode::Type::FieldNode:
+                return evaluateFieldNode(static_cast<const FieldNode*>(node), currentScope);
+            case ASTNode::Type::NullNode:
+                return Value();
+            default:
+                throw std::runtime_error("Unknown expression node type");
+        }
+    } catch (...) {
+        throw;
+    }
+}
+
+
+// Evaluate the if node
+void evaluateIf(const IfNode* ifNode, const std::shared_ptr<Scope>& currentScope) {
+    try {
+        Value conditionValue = evaluateExpression(ifNode->condition.get(), currentScope);
+        if (executionCounters) {
+            executionCounters->countBranch(ifNode, conditionValue.asBool());
+        }
+        if (conditionValue.asBool()) {
+            evaluateBlock(static_cast<const BlockNode*>(ifNode->trueBranch.get()), currentScope);
+        } else if (ifNode->falseBranch) {
+            evaluateStatement(ifNode->falseBranch.get(), currentScope);
+        }
+    } catch (...) {
+        throw;
+    }
+}
+
+// Most bytes reserved ahead of a push loop. The bounds only say how long the
+// loop would run, and a loop left early by return would keep the whole block,
+// so longer loops grow as usual from there.
+static const size_t PushLoopReserveBytes = 64 * 1024;
+
+// Value of a number literal or of a variable holding a number, for a loop's
+// bounds; false for anything else
+static bool loopNumber(const ASTNode* node, const std::shared_ptr<Scope>& currentScope, double& number) {
+    if (node->getType() == ASTNode::Type::NumberNode) {
+        number = std::stod(static_cast<const NumberNode*>(node)->value.value);
+        return true;
+    }
+    if (node->getType() == ASTNode::Type::VariableNode) {
+        const Value* value = currentScope->getVariable(static_cast<const VariableNode*>(node)->symbol);
+        if (value && value->getType() == Value::Type::Double) {
+            number = value->asDouble();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reserves the elements of a loop of the shape
+//     while i < n { ... push(a, x); ... i = i + step; }
+// where push and the increment are statements of the body itself, so every
+// iteration pushes one element, and n and step are numbers or variables.
+// The array is then allocated once instead of doubling as the loop runs. Only
+// its capacity changes, so a loop that breaks the pattern later, say by
+// changing n, still runs correctly.
+static void reservePushLoop(const WhileNode* whileNode, const std::shared_ptr<Scope>& currentScope) {
+    if (whileNode->condition->getType() != ASTNode::Type::BinaryOpNode ||
+        whileNode->body->getType() != ASTNode::Type::BlockNode) {
+        return;
+    }
+    auto condition = static_cast<const BinaryOpNode*>(whileNode->condition.get());
+    if ((condition->op.type != TokenType::LESS && condition->op.type != TokenType::LESS_EQUAL) ||
+        condition->left->getType() != ASTNode::Type::VariableNode) {
+        return;
+    }
+    Symbol counter = static_cast<const VariableNode*>(condition->left.get())->symbol;
+
+    const VariableNode* pushed = nullptr;
+    const ASTNode* stepNode = nullptr;
+    for (const auto& statement : static_cast<const BlockNode*>(whileNode->body.get())->statements) {
+        if (statement->getType() == ASTNode::Type::CallNode) {
+            auto callNode = static_cast<const CallNode*>(statement.get());
+            if (callNode->callee->getType() == ASTNode::Type::VariableNode &&
+                static_cast<const VariableNode*>(callNode->callee.get())->identifier.value == "push" &&
+                callNode->arguments.size() == 2 &&
+                callNode->arguments[0]->getType() == ASTNode::Type::VariableNode) {
+                pushed = static_cast<const VariableNode*>(callNode->arguments[0].get());
+            }
+        } else if (statement->getType() == ASTNode::Type::AssignmentNode) {
+            auto assignmentNode = static_cast<const AssignmentNode*>(statement.get());
+            if (assignmentNode->lhs->getType() != ASTNode::Type::VariableNode ||
+                static_cast<const VariableNode*>(assignmentNode->lhs.get())->symbol != counter ||
+                assignmentNode->rhs->getType() != ASTNode::Type::BinaryOpNode) {
+                continue;
+            }
+            auto increment = static_cast<const BinaryOpNode*>(assignmentNode->rhs.get());
+            if (increment->op.type == TokenType::ADD && increment->left->getType() == ASTNode::Type::VariableNode &&
+                static_cast<const VariableNode*>(increment->left.get())->symbol == counter) {
+                stepNode = increment->right.get();
+            }
+        }
+    }
+    double first;
+    double limit;
+    double step;
+    if (!pushed || !stepNode || !loopNumber(condition->left.get(), currentScope, first) ||
+        !loopNumber(condition->right.get(), currentScope, limit) || !loopNumber(stepNode, currentScope, step) ||
+        !(step > 0)) {
+        return;
+    }
+    Value* arrayValue = currentScope->getVariable(pushed->symbol);
+    if (!arrayValue || !arrayValue->isArray()) {
+        return;
+    }
+    double iterations = condition->op.type == TokenType::LESS ? std::ceil((limit - first) / step)
+                                                              : std::floor((limit - first) / step) + 1;
+    if (!(iterations > 0)) {
+        return;
+    }
+    const size_t most = PushLoopReserveBytes / sizeof(Value);
+    size_t count = iterations < most ? static_cast<size_t>(iterations) : most;
+    std::vector<Value>& array = arrayValue->asArray();
+    if (array.capacity() - array.size() < count) {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        array.reserve(array.size() + count);
+    }
+}
+
+// Evaluate the while node
+void evaluateWhile(const WhileNode* whileNode, const std::shared_ptr<Scope>& currentScope) {
+    try {
+        reservePushLoop(whileNode, currentScope);
+        while (true) {
+            Value conditionValue = evaluateExpression(whileNode->condition.get(), currentScope);
+            if (!conditionValue.asBool()) {
+                break;
+            }
+            if (executionCounters) {
+                executionCounters->countIteration(whileNode);
+            }
+            std::shared_ptr<Scope> loopScope;
+            {
+                HeapCategoryScope heap(HeapCategory::Scopes);
+                loopScope = Scope::create(currentScope);
+            }
+            evaluateBlock(static_cast<const BlockNode*>(whileNode->body.get()), loopScope);
+            loopScope->getVariables().forEach([&currentScope](Symbol name, const Value& value) {
+                if (currentScope->hasVariable(name)) {
+                    currentScope->setVariable(name, value);
+                }
+            });
+        }
+    } catch (...) {
+        throw;
+    }
+}
+
+
+// Evaluate Return (functions)
+void evaluateReturn(const ReturnNode* returnNode, const std::shared_ptr<Scope>& currentScope) {
+    try {
+        Value returnValue;
+        if (returnNode->value) {
+            returnValue = evaluateExpression(returnNode->value.get(), currentScope);
+        } else {
+            throw ReturnException(Value());
+        }
+        throw ReturnException(std::move(returnValue));
+    } catch (...) {
+        throw;
+    }
+}
+
+//helper function with print
+void printValue(std::ostream& os, const Value& value) {
+    switch (value.getType()) {
+        case Value::Type::Double:
+            os << value.asDouble();
+            break;
+
+        case Value::Type::Bool:
+            os << std::boolalpha << value.asBool();
+            break;
+
+        case Value::Type::Null:
+            os << "null";
+            break;
+
+        case Value::Type::String:
+            os << value.asString()->text();
+            break;
+
+        case Value::Type::Array: {
+            os << "[";
+            const auto& array = value.asArray();
+            for (size_t i = 0; i < array.size(); ++i) {
+                if (i > 0) os << ", ";
+                printValue(os, array[i]);
+            }
+            os << "]";
+            break;
+        }
+
+        case Value::Type::Matrix: {
+            const MatrixData& matrix = value.asMatrix();
+            os << "[";
+            for (size_t i = 0; i < matrix.rows(); ++i) {
+                if (i > 0) os << ", ";
+                os << "[";
+                for (size_t j = 0; j < matrix.columns(); ++j) {
+                    if (j > 0) os << ", ";
+                    os << matrix.row(i)[j];
+                }
+                os << "]";
+            }
+            os << "]";
+            break;
+        }
+
+        case Value::Type::Vector: {
+            os << "[";
+            const VectorData& vector = value.asVector();
+            for (size_t i = 0; i < vector.size(); ++i) {
+                if (i > 0) os << ", ";
+                printValue(os, vector.at(i));
+            }
+            os << "]";
+            break;
+        }
+
+        case Value::Type::Record: {
+            const RecordData& record = value.asRecord();
+            os << record.layout()->name << "{";
+            for (size_t i = 0; i < record.size(); ++i) {
+                if (i > 0) os << ", ";
+                os << record.layout()->fields[i]->name << ": ";
+                printValue(os, record.slot(i));
+            }
+            os << "}";
+            break;
+        }
+
+        case Value::Type::Map: {
+            os << "{";
+            bool first = true;
+            value.asMap().forEach([&os, &first](const Value& key, const Value& element) {
+                if (!first) os << ", ";
+                first = false;
+                printValue(os, key);
+                os << ": ";
+                printValue(os, element);
+            });
+            os << "}";
+            break;
+        }
+
+        default:
+            os << "/* Unsupported type */";
+            break;
+    }
+}
+
+// Evaluate the print node
+void evaluatePrint(const PrintNode* printNode, const std::shared_ptr<Scope>& currentScope) {
+    Operand value(printNode->expression.get(), currentScope, true);
+    printValue(*scriptOutput, value.get());
+    *scriptOutput << std::endl;
+}
+
+// Applies operation to the elements of left and right. A step of 0 repeats
+// the first element, for a number on one side.
+template <typename Operation>
+static void combineElements(const double* left, size_t leftStep, const double* right, size_t rightStep,
+                            double* result, size_t count, Operation operation) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = operation(left[i * leftStep], right[i * rightStep]);
+    }
+}
+
+// Element-wise + - * / with a matrix on at least one side. The other side is
+// a matrix of the same shape or a number, used for every element.
+static Value matrixArithmetic(TokenType op, const Value& left, const Value& right) {
+    const MatrixData& shape = left.isMatrix() ? left.asMatrix() : right.asMatrix();
+    if (left.isMatrix() && right.isMatrix() &&
+        (right.asMatrix().rows() != shape.rows() || right.asMatrix().columns() != shape.columns())) {
+        throw std::runtime_error("Runtime error: matrix shapes differ.");
+    }
+    double leftNumber = left.isMatrix() ? 0 : left.asDouble();
+    double rightNumber = right.isMatrix() ? 0 : right.asDouble();
+    const double* leftElements = left.isMatrix() ? left.asMatrix().data() : &leftNumber;
+    const double* rightElements = right.isMatrix() ? right.asMatrix().data() : &rightNumber;
+    size_t leftStep = left.isMatrix() ? 1 : 0;
+    size_t rightStep = right.isMatrix() ? 1 : 0;
+    size_t count = shape.size();
+
+    MatrixData result(shape.rows(), shape.columns());
+    switch (op) {
+        case TokenType::ADD:
+            combineElements(leftElements, leftStep, rightElements, rightStep, result.data(), count,
+                            [](double x, double y) { return x + y; });
+            break;
+        case TokenType::SUBTRACT:
+            combineElements(leftElements, leftStep, rightElements, rightStep, result.data(), count,
+                            [](double x, double y) { return x - y; });
+            break;
+        case TokenType::MULTIPLY:
+            combineElements(leftElements, leftStep, rightElements, rightStep, result.data(), count,
+                            [](double x, double y) { return x * y; });
+            break;
+        default: {
+            size_t divisors = right.isMatrix() ? count : 1;
+            if (std::find(rightElements, rightElements + divisors, 0.0) != rightElements + divisors) {
+                throw std::runtime_error("Division by zero.");
+            }
+            combineElements(leftElements, leftStep, rightElements, rightStep, result.data(), count,
+                            [](double x, double y) { return x / y; });
+            break;
+        }
+    }
+    return Value(std::move(result));
+}
+
+// Evaluate Operations
+Value evaluateBinaryOperation(const BinaryOpNode* binaryOpNode, const std::shared_ptr<Scope>& currentScope) {
+try{
+    if (!binaryOpNode) {
+        throw std::runtime_error("Null BinaryOpNode passed to evaluateBinaryOperation");
+    }
+
+    // The left operand is only borrowed when evaluating the right one cannot
+    // assign and so move it
+    Operand leftOperand(binaryOpNode->left.get(), currentScope, isPure(binaryOpNode->right.get()));
+    Operand rightOperand(binaryOpNode->right.get(), currentScope, binaryOpNode->op.type != TokenType::ASSIGN);
+    const Value& left = leftOperand.get();
+    const Value& right = rightOperand.get();
+
+    switch (binaryOpNode->op.type) {
+        case TokenType::ADD:
+            if (left.isString() || right.isString()) {
+                return Value(StringData::concat(concatOperand(left), concatOperand(right)));
+            }
+            if (left.isMatrix() || right.isMatrix()) {
+                return matrixArithmetic(binaryOpNode->op.type, left, right);
+            }
+            return Value(left.asDouble() + right.asDouble());
+        case TokenType::SUBTRACT:
+            if (left.isMatrix() || right.isMatrix()) {
+                return matrixArithmetic(binaryOpNode->op.type, left, right);
+            }
+            return Value(left.asDouble() - right.asDouble());
+        case TokenType::MULTIPLY:
+            if (left.isMatrix() || right.isMatrix()) {
+                return matrixArithmetic(binaryOpNode->op.type, left, right);
+            }
+            return Value(left.asDouble() * right.asDouble());
+        case TokenType::DIVIDE:
+            if (left.isMatrix() || right.isMatrix()) {
+                return matrixArithmetic(binaryOpNode->op.type, left, right);
+            }
+            if (right.asDouble() == 0) {
+                throw std::runtime_error("Division by zero.");
+            }
+            return Value(left.asDouble() / right.asDouble());
+        case TokenType::MODULO:
+            if (right.asDouble() == 0) {
+                throw std::runtime_error("Modulo by zero.");
+            }
+            return Value(fmod(left.asDouble(), right.asDouble()));
+        case TokenType::LESS:
+            if (left.isString()) {
+                return Value(compareStrings(left, right) < 0);
+            }
+            return Value(left.asDouble() < right.asDouble());
+        case TokenType::LESS_EQUAL:
+            if (left.isString()) {
+                return Value(compareStrings(left, right) <= 0);
+            }
+            return Value(left.asDouble() <= right.asDouble());
+        case TokenType::GREATER:
+            if (left.isString()) {
+                return Value(compareStrings(left, right) > 0);
+            }
+            return Value(left.asDouble() > right.asDouble());
+        case TokenType::GREATER_EQUAL:
+            if (left.isString()) {
+                return Value(compareStrings(left, right) >= 0);
+            }
+            return Value(left.asDouble() >= right.asDouble());
+        case TokenType::EQUAL:
+            return Value(left.equals(right));
+        case TokenType::NOT_EQUAL:
+            return Value(!left.equals(right));
+        case TokenType::LOGICAL_AND:
+            return Value(left.asBool() && right.asBool());
+        case TokenType::LOGICAL_OR:
+            return Value(left.asBool() || right.asBool());
+        case TokenType::LOGICAL_XOR: 
+            return Value(left.asBool() != right.asBool());
+        case TokenType::ASSIGN:
+            if (binaryOpNode->left->getType() == ASTNode::Type::VariableNode) {
+                const auto* variableNode = static_cast<const VariableNode*>(binaryOpNode->left.get());
+                currentScope->setVariable(variableNode->symbol, right);
+                return right;
+            } else {
+                throw std::runtime_error("Invalid left-hand side in assignment");
+            }
+        default:
+            throw std::runtime_error("Unsupported binary operator in evaluateBinaryOperation");
+    }
+} catch (...) {
+    throw;
+}
+}
+// Evaluate variables
+Value evaluateVariable(const VariableNode* variableNode, const std::shared_ptr<Scope>& currentScope) {
+    if (!variableNode) {
+        throw std::runtime_error("Null VariableNode passed to evaluateVariable");
+    }
+
+    Value* valuePtr = currentScope->getVariable(variableNode->symbol);
+    if (valuePtr) {
+        return *valuePtr;
+    } else {
+        throw std::runtime_error("Runtime error: unknown identifier " + variableNode->identifier.value);
+    }
+}
+
+
+// Evaluate Assignments
+Value evaluateAssignment(const AssignmentNode* assignmentNode, const std::shared_ptr<Scope>& currentScope) {
+    try {
+    if (!assignmentNode) {
+        throw std::runtime_error("Null assignment node passed to evaluateAssignment");
+    }
+
+    Value rhsValue = evaluateExpression(assignmentNode->rhs.get(), currentScope);
+
+    if (assignmentNode->lhs->getType() == ASTNode::Type::FieldNode) {
+        // Writes the slot in the record itself, which every holder of the record sees
+        auto fieldNode = static_cast<const FieldNode*>(assignmentNode->lhs.get());
+        Value recordValue = evaluateExpression(fieldNode->record.get(), currentScope);
+        RecordData& record = recordValue.asRecord();
+        record.slot(fieldSlot(record, fieldNode)) = rhsValue;
+        return rhsValue;
+    }
+
+    if (assignmentNode->lhs->getType() == ASTNode::Type::ArrayLookupNode) {
+        auto arrayLookupNode = static_cast<const ArrayLookupNode*>(assignmentNode->lhs.get());
+        if (arrayLookupNode->array->getType() == ASTNode::Type::VariableNode) {
+            auto variableNode = static_cast<const VariableNode*>(arrayLookupNode->array.get());
+            const Value* target = currentScope->getVariable(variableNode->symbol);
+            if (target && target->isMap()) {
+                // Holds the map itself, since evaluating the key may move the variable
+                Value mapValue = *target;
+                Value key = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+                checkMapKey(key);
+                HeapCategoryScope heap(HeapCategory::Arrays);
+                mapValue.asMap()[key] = rhsValue;
+                return rhsValue;
+            }
+        }
+        if (arrayLookupNode->array->getType() == ASTNode::Type::ArrayLookupNode) {
+            // m[i][j] = x writes one element of a matrix in place
+            auto rowLookupNode = static_cast<const ArrayLookupNode*>(arrayLookupNode->array.get());
+            if (rowLookupNode->array->getType() == ASTNode::Type::VariableNode) {
+                auto variableNode = static_cast<const VariableNode*>(rowLookupNode->array.get());
+                const Value* target = currentScope->getVariable(variableNode->symbol);
+                if (target && target->isMatrix()) {
+                    // Holds the matrix itself, since evaluating the indexes may move the variable
+                    Value matrixValue = *target;
+                    Value rowIndex = evaluateExpression(rowLookupNode->index.get(), currentScope);
+                    Value columnIndex = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+                    MatrixData& matrix = matrixValue.asMatrix();
+                    size_t row = checkedIndex(rowIndex, matrix.rows());
+                    matrix.row(row)[checkedIndex(columnIndex, matrix.columns())] = rhsValue.asDouble();
+                    return rhsValue;
+                }
+            }
+        }
+    }
+    if (assignmentNode->lhs->getType() == ASTNode::Type::ArrayLookupNode &&
+        assignmentNode->rhs->getType() == ASTNode::Type::ArrayLiteralNode) {
+        return rhsValue;
+    }
+    if (assignmentNode->lhs->getType() == ASTNode::Type::VariableNode) {
+        auto variableNode = static_cast<const VariableNode*>(assignmentNode->lhs.get());
+        currentScope->setVariable(variableNode->symbol, rhsValue);
+    } else if (assignmentNode->lhs->getType() == ASTNode::Type::ArrayLookupNode) {
+        auto arrayLookupNode = static_cast<const ArrayLookupNode*>(assignmentNode->lhs.get());
+
+        if (arrayLookupNode->array->getType() != ASTNode::Type::VariableNode) {
+            throw std::runtime_error("Runtime error: not an array.");
+        }
+        auto variableNode = static_cast<const VariableNode*>(arrayLookupNode->array.get());
+        const Value* arrayValuePtr = currentScope->getVariable(variableNode->symbol);
+
+        if (!arrayValuePtr || arrayValuePtr->getType() != Value::Type::Array) {
+            throw std::runtime_error("Runtime error: not an array.");
+        }
+        // Holds the array itself, since evaluating the index may move the variable
+        Value arrayValue = *arrayValuePtr;
+        Value indexValue = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+        size_t index = elementIndex(arrayValue, indexValue);
+
+        // The rhs is evaluated before the elements are taken for writing: it
+        // may be a slice of this very array, which taking them detaches first
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        arrayValue.asArray()[index] = rhsValue;
+
+        return rhsValue;
+    }
+    else {
+        throw std::runtime_error("Runtime error: invalid assignee.");
+    }
+
+    return rhsValue;
+}
+catch (...) {
+    throw;
+}
+}
+
+// Evaluate Array Literals
+Value evaluateArrayLiteralNode(const ArrayLiteralNode* arrayLiteralNode, const std::shared_ptr<Scope>& currentScope) {
+    try{
+    if (!arrayLiteralNode) {
+        throw std::runtime_error("Null ArrayLiteralNode passed to evaluateArrayLiteralNode");
+    }
+
+    std::vector<Value> arrayValues;
+    for (const auto& element : arrayLiteralNode->elements) {
+        Value copiedElement = Operand(element.get(), currentScope, true).get().deepCopy();
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        arrayValues.push_back(std::move(copiedElement));
+    }
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    return Value(std::move(arrayValues));
+    } catch (...) {
+        throw;
+    }
+}
+
+// Evaluate Map Literals. Like array elements, the values are deep copies.
+Value evaluateMapLiteralNode(const MapLiteralNode* mapLiteralNode, const std::shared_ptr<Scope>& currentScope) {
+    ValueMap map;
+    for (size_t i = 0; i < mapLiteralNode->keys.size(); ++i) {
+        Value key = evaluateExpression(mapLiteralNode->keys[i].get(), currentScope);
+        checkMapKey(key);
+        Value value = Operand(mapLiteralNode->values[i].get(), currentScope, true).get().deepCopy();
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        map[key] = std::move(value);
+    }
+    return Value(std::move(map));
+}
+
+// container[index] for a map, a string, a matrix, a vector or an array
+static Value elementOf(const Value& container, const Value& indexValue) {
+    if (container.isMap()) {
+        return mapEntry(container, indexValue);
+    }
+    if (container.isVector()) {
+        return vectorElement(container, indexValue);
+    }
+    if (container.isString()) {
+        return characterAt(container, indexValue);
+    }
+    if (container.isMatrix()) {
+        return matrixRow(container, indexValue);
+    }
+    return container.asArray()[elementIndex(container, indexValue)];
+}
+
+// Evaluate and return the Array Literals
+Value evaluateArrayLookupNode(const ArrayLookupNode* arrayLookupNode, const std::shared_ptr<Scope>& currentScope) {
+    try{
+    if (!arrayLookupNode) {
+        throw std::runtime_error("Null ArrayLookupNode passed to evaluateArrayLookupNode");
+    }
+
+    if (const Value* element = borrowValue(arrayLookupNode, currentScope)) {
+        return *element;
+    }
+    if (arrayLookupNode->array->getType() == ASTNode::Type::ArrayLookupNode) {
+        // m[i][j] on a matrix reads the element without building row i
+        auto rowLookupNode = static_cast<const ArrayLookupNode*>(arrayLookupNode->array.get());
+        Operand outer(rowLookupNode->array.get(), currentScope,
+                      isPure(rowLookupNode->index.get()) && isPure(arrayLookupNode->index.get()));
+        Value rowIndex = evaluateExpression(rowLookupNode->index.get(), currentScope);
+        if (outer.get().isMatrix()) {
+            Value columnIndex = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+            return matrixElement(outer.get(), rowIndex, columnIndex);
+        }
+        const Value rowValue = elementOf(outer.get(), rowIndex);
+        Value indexValue = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+        return elementOf(rowValue, indexValue);
+    }
+    const Value arrayValue = evaluateExpression(arrayLookupNode->array.get(), currentScope);
+    Value indexValue = evaluateExpression(arrayLookupNode->index.get(), currentScope);
+    return elementOf(arrayValue, indexValue);
+}
+catch (...) {
+    throw;
+}
+}
+
+// Evaluate a[begin:end]. The array is borrowed when evaluating the bounds
+// cannot move it.
+Value evaluateSliceNode(const SliceNode* sliceNode, const std::shared_ptr<Scope>& currentScope) {
+    bool boundsArePure = (!sliceNode->begin || isPure(sliceNode->begin.get())) &&
+                         (!sliceNode->end || isPure(sliceNode->end.get()));
+    Operand sequence(sliceNode->array.get(), currentScope, boundsArePure);
+    Value beginValue;
+    Value endValue;
+    if (sliceNode->begin) {
+        beginValue = evaluateExpression(sliceNode->begin.get(), currentScope);
+    }
+    if (sliceNode->end) {
+        endValue = evaluateExpression(sliceNode->end.get(), currentScope);
+    }
+    return sliceValue(sequence.get(), sliceNode->begin ? &beginValue : nullptr, sliceNode->end ? &endValue : nullptr);
+}
+
+// Evaluate record.field. The record is borrowed, since evaluating a field
+// name cannot move it.
+Value evaluateFieldNode(const FieldNode* fieldNode, const std::shared_ptr<Scope>& currentScope) {
+    Operand recordOperand(fieldNode->record.get(), currentScope, true);
+    const RecordData& record = recordOperand.get().asRecord();
+    return record.slot(fieldSlot(record, fieldNode));
+}
+
+// slice(a, begin[, end]): like a[begin:end]
+Value sliceFunction(Arguments args) {
+    if (args.size() != 2 && args.size() != 3) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    return sliceValue(args[0], &args[1], args.size() == 3 ? &args[2] : nullptr);
+}
+
+// Len Function of Arrays, maps, strings, vectors and matrices (their rows)
+Value lenFunction(Arguments args) {
+    if (args.size() == 1 && args[0].isVector()) {
+        return Value(static_cast<double>(args[0].asVector().size()));
+    }
+    if (args.size() == 1 && args[0].isMap()) {
+        return Value(static_cast<double>(args[0].asMap().size()));
+    }
+    if (args.size() == 1 && args[0].isString()) {
+        return Value(static_cast<double>(args[0].asString()->size()));
+    }
+    if (args.size() == 1 && args[0].isMatrix()) {
+        return Value(static_cast<double>(args[0].asMatrix().rows()));
+    }
+    const Value& array = args[0];
+    if (args.size() != 1 || !array.isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    return Value(static_cast<double>(array.asArray().size()));
+}
+
+// has(map, key): whether key is in the map
+Value hasFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isMap()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    checkMapKey(args[1]);
+    return Value(args[0].asMap().find(args[1]) != nullptr);
+}
+
+// delete(map, key): removes key, returning whether it was there
+Value deleteFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isMap()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    checkMapKey(args[1]);
+    return Value(args[0].asMap().erase(args[1]));
+}
+
+// keys(map) and values(map): arrays in insertion order
+Value keysFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isMap()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> keys;
+    keys.reserve(args[0].asMap().size());
+    args[0].asMap().forEach([&keys](const Value& key, const Value&) { keys.push_back(key); });
+    return Value(std::move(keys));
+}
+
+Value valuesFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isMap()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> values;
+    values.reserve(args[0].asMap().size());
+    args[0].asMap().forEach([&values](const Value&, const Value& value) { values.push_back(value); });
+    return Value(std::move(values));
+}
+
+// Builtins that are called by name unless the script defines the name itself
+Builtin findBuiltin(Symbol name) {
+    static const SymbolMap<Builtin> table = [] {
+        SymbolMap<Builtin> builtins;
+        builtins[intern("has")] = hasFunction;
+        builtins[intern("delete")] = deleteFunction;
+        builtins[intern("keys")] = keysFunction;
+        builtins[intern("values")] = valuesFunction;
+        builtins[intern("slice")] = sliceFunction;
+        builtins[intern("sort")] = sortFunction;
+        builtins[intern("bsearch")] = bsearchFunction;
+        builtins[intern("reverse")] = reverseFunction;
+        builtins[intern("fill")] = fillFunction;
+        builtins[intern("concat")] = concatFunction;
+        builtins[intern("reserve")] = reserveFunction;
+        builtins[intern("array")] = arrayFunction;
+        builtins[intern("psort")] = psortFunction;
+        builtins[intern("pscan")] = pscanFunction;
+        builtins[intern("sqrt")] = sqrtFunction;
+        builtins[intern("exp")] = expFunction;
+        builtins[intern("log")] = logFunction;
+        builtins[intern("sin")] = sinFunction;
+        builtins[intern("cos")] = cosFunction;
+        builtins[intern("pow")] = powFunction;
+        builtins[intern("abs")] = absFunction;
+        builtins[intern("floor")] = floorFunction;
+        builtins[intern("matrix")] = matrixFunction;
+        builtins[intern("shape")] = shapeFunction;
+        builtins[intern("matmul")] = matmulFunction;
+        builtins[intern("pmatmul")] = pmatmulFunction;
+        builtins[intern("transpose")] = transposeFunction;
+        builtins[intern("vector")] = vectorFunction;
+        builtins[intern("assoc")] = assocFunction;
+        builtins[intern("conj")] = conjFunction;
+        return builtins;
+    }();
+    const Builtin* found = table.find(name);
+    return found ? *found : nullptr;
+}
+
+// Pop function of arrays
+Value popFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    auto& array = args[0].asArray();
+    if (array.empty()) {
+        throw std::runtime_error("pop from an empty array.");
+    }
+    Value poppedValue = std::move(array.back());
+    array.pop_back();
+    return poppedValue;
+}
+
+// push function of arrays
+Value pushFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    auto& array = args[0].asArray();
+    size_t capacity = array.capacity();
+    {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        array.push_back(std::move(args[1]));
+    }
+    if (tracer && array.capacity() != capacity) {
+        tracer->instant("array", "array grow", static_cast<int64_t>(array.capacity()));
+    }
+    return Value();
+}
+
+
+// Order of sort and bsearch: numbers ascending with NaN last, or strings
+// lexicographically. Other pairs are an invalid operand type.
+static bool sortsBefore(const Value& a, const Value& b) {
+    if (a.isString() && b.isString()) {
+        return a.asString()->compare(*b.asString()) < 0;
+    }
+    double x = a.asDouble();
+    double y = b.asDouble();
+    return x < y || (y != y && x == x);
+}
+
+// Copies the elements of an array into numbers, returning false when one of
+// them is not a number
+static bool copyNumbers(const Value& arrayValue, std::vector<double>& numbers) {
+    ArrayElements elements = arrayValue.asArray();
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    numbers.reserve(elements.size());
+    for (const Value& element : elements) {
+        if (element.getType() != Value::Type::Double) {
+            return false;
+        }
+        numbers.push_back(element.asDouble());
+    }
+    return true;
+}
+
+// Writes numbers back over the elements of an array of the same size
+static void storeNumbers(Value& arrayValue, const std::vector<double>& numbers) {
+    std::vector<Value>& array = arrayValue.asArray();
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        array[i] = Value(numbers[i]);
+    }
+}
+
+// New array holding numbers
+static Value arrayOfNumbers(const std::vector<double>& numbers) {
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> array;
+    array.reserve(numbers.size());
+    for (double number : numbers) {
+        array.push_back(Value(number));
+    }
+    return Value(std::move(array));
+}
+
+// Sorts a copy of the elements with a script comparator, less(a, b) returning
+// whether a goes before b. A bottom-up merge sort: it is stable, and its loops
+// stay in bounds even when the comparator is inconsistent.
+static std::vector<Value> sortWithComparator(std::vector<Value> elements, const Value& less) {
+    auto before = [&less](const Value& a, const Value& b) {
+        Value pair[2] = {a, b};
+        return callFunction(less, Arguments(pair, 2), 0).asBool();
+    };
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> merged(elements.size());
+    for (size_t width = 1; width < elements.size(); width *= 2) {
+        for (size_t left = 0; left < elements.size(); left += 2 * width) {
+            size_t middle = std::min(left + width, elements.size());
+            size_t right = std::min(left + 2 * width, elements.size());
+            size_t i = left;
+            size_t j = middle;
+            size_t out = left;
+            while (i < middle && j < right) {
+                merged[out++] = std::move(before(elements[j], elements[i]) ? elements[j++] : elements[i++]);
+            }
+            while (i < middle) {
+                merged[out++] = std::move(elements[i++]);
+            }
+            while (j < right) {
+                merged[out++] = std::move(elements[j++]);
+            }
+        }
+        elements.swap(merged);
+    }
+    return elements;
+}
+
+// sort(a) sorts an array of numbers or of strings in place; sort(a, less)
+// orders any array by a script comparator
+Value sortFunction(Arguments args) {
+    if ((args.size() != 1 && args.size() != 2) || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    Value& arrayValue = args[0];
+    if (args.size() == 2) {
+        Value less = args[1];
+        std::vector<Value> sorted = sortWithComparator(std::vector<Value>(arrayValue.asArray()), less);
+        arrayValue.asArray() = std::move(sorted);
+        return Value();
+    }
+
+    std::vector<double> numbers;
+    if (!copyNumbers(arrayValue, numbers)) {
+        std::vector<Value>& array = arrayValue.asArray();
+        for (const Value& element : array) {
+            if (!element.isString()) {
+                throw std::runtime_error("Runtime error: invalid operand type.");
+            }
+        }
+        std::sort(array.begin(), array.end(), sortsBefore);
+        return Value();
+    }
+    // Numbers are sorted as plain doubles, with NaNs moved to the end first so
+    // that the rest has a strict order
+    auto numbersEnd = std::partition(numbers.begin(), numbers.end(), [](double x) { return x == x; });
+    std::sort(numbers.begin(), numbersEnd);
+    storeNumbers(arrayValue, numbers);
+    return Value();
+}
+
+// Arrays up to this size are sorted and scanned on the calling thread. The
+// parallel versions split larger ones into pieces of this size regardless of
+// the number of threads, so their results do not depend on it.
+static const size_t ParallelPieceSize = 16384;
+
+// Sorts numbers in pieces on the work pool, then merges neighbouring runs in
+// rounds. Every merge is stable, so equal numbers such as -0 and 0 end up in
+// the same order however the pieces were scheduled.
+static void parallelSort(std::vector<double>& numbers) {
+    size_t pieces = (numbers.size() + ParallelPieceSize - 1) / ParallelPieceSize;
+    WorkPool& pool = WorkPool::shared();
+    pool.parallelFor(pieces, [&numbers](size_t piece) {
+        auto first = numbers.begin() + piece * ParallelPieceSize;
+        auto last = numbers.begin() + std::min((piece + 1) * ParallelPieceSize, numbers.size());
+        std::sort(first, last);
+    });
+    std::vector<double> merged;
+    {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        merged.resize(numbers.size());
+    }
+    for (size_t width = ParallelPieceSize; width < numbers.size(); width *= 2) {
+        size_t pairs = (numbers.size() + 2 * width - 1) / (2 * width);
+        pool.parallelFor(pairs, [&numbers, &merged, width](size_t pair) {
+            size_t left = pair * 2 * width;
+            size_t middle = std::min(left + width, numbers.size());
+            size_t right = std::min(left + 2 * width, numbers.size());
+            std::merge(numbers.begin() + left, numbers.begin() + middle, numbers.begin() + middle,
+                       numbers.begin() + right, merged.begin() + left);
+        });
+        numbers.swap(merged);
+    }
+}
+
+// psort(a): sort(a) for an array of numbers, on the work pool when it is large
+Value psortFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    std::vector<double> numbers;
+    if (!copyNumbers(args[0], numbers)) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    auto numbersEnd = std::partition(numbers.begin(), numbers.end(), [](double x) { return x == x; });
+    if (numbers.size() <= ParallelPieceSize) {
+        std::sort(numbers.begin(), numbersEnd);
+    } else {
+        std::vector<double> sortable(numbers.begin(), numbersEnd);
+        parallelSort(sortable);
+        std::copy(sortable.begin(), sortable.end(), numbers.begin());
+    }
+    storeNumbers(args[0], numbers);
+    return Value();
+}
+
+// pscan(a): new array of the running totals of an array of numbers. Large
+// arrays are scanned piece by piece on the work pool: each piece is summed on
+// its own, then shifted by the total of the pieces before it.
+Value pscanFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    std::vector<double> numbers;
+    if (!copyNumbers(args[0], numbers)) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    size_t pieces = (numbers.size() + ParallelPieceSize - 1) / ParallelPieceSize;
+    auto scanPiece = [&numbers](size_t piece) {
+        size_t last = std::min((piece + 1) * ParallelPieceSize, numbers.size());
+        for (size_t i = piece * ParallelPieceSize + 1; i < last; ++i) {
+            numbers[i] += numbers[i - 1];
+        }
+    };
+    if (pieces <= 1) {
+        scanPiece(0);
+    } else {
+        WorkPool& pool = WorkPool::shared();
+        pool.parallelFor(pieces, scanPiece);
+        std::vector<double> offsets(pieces, 0.0);
+        for (size_t piece = 1; piece < pieces; ++piece) {
+            offsets[piece] = offsets[piece - 1] + numbers[piece * ParallelPieceSize - 1];
+        }
+        pool.parallelFor(pieces - 1, [&numbers, &offsets](size_t i) {
+            size_t piece = i + 1;
+            size_t last = std::min((piece + 1) * ParallelPieceSize, numbers.size());
+            for (size_t j = piece * ParallelPieceSize; j < last; ++j) {
+                numbers[j] += offsets[piece];
+            }
+        });
+    }
+    return arrayOfNumbers(numbers);
+}
+
+// bsearch(a, x): index of x in an array sorted by sort(a), or -1
+Value bsearchFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const Value& arrayValue = args[0];
+    ArrayElements array = arrayValue.asArray();
+    const Value& target = args[1];
+    const Value* found = std::lower_bound(array.begin(), array.end(), target, sortsBefore);
+    if (found != array.end() && !sortsBefore(target, *found)) {
+        return Value(static_cast<double>(found - array.begin()));
+    }
+    return Value(-1.0);
+}
+
+// reverse(a): reverses an array in place
+Value reverseFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    std::vector<Value>& array = args[0].asArray();
+    std::reverse(array.begin(), array.end());
+    return Value();
+}
+
+// fill(a, v): sets every element to a deep copy of v, like an array literal
+Value fillFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    Value fillValue = args[1].deepCopy();
+    for (Value& element : args[0].asArray()) {
+        element = fillValue.deepCopy();
+    }
+    return Value();
+}
+
+// concat(a, b, ...): new array with the elements of all the arrays in order
+Value concatFunction(Arguments args) {
+    size_t total = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const Value& part = args[i];
+        total += part.asArray().size();
+    }
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> result;
+    result.reserve(total);
+    for (size_t i = 0; i < args.size(); ++i) {
+        const Value& part = args[i];
+        ArrayElements elements = part.asArray();
+        result.insert(result.end(), elements.begin(), elements.end());
+    }
+    return Value(std::move(result));
+}
+
+// array(n) is a new array of n nulls; array(n, v) fills it with copies of v,
+// copied as in an array literal
+Value arrayFunction(Arguments args) {
+    if (args.size() != 1 && args.size() != 2) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    double count = args[0].asDouble();
+    if (!args[0].isInteger() || count < 0 || count > static_cast<double>(std::vector<Value>().max_size())) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    Value fillValue = args.size() == 2 ? args[1].deepCopy() : Value();
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value> elements;
+    try {
+        elements.reserve(static_cast<size_t>(count));
+    } catch (const std::bad_alloc&) {
+        throw std::runtime_error("Runtime error: out of memory.");
+    } catch (const std::length_error&) {
+        throw std::runtime_error("Runtime error: out of memory.");
+    }
+    for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+        elements.push_back(fillValue.deepCopy());
+    }
+    return Value(std::move(elements));
+}
+
+// reserve(a, n): makes room for n elements, so pushing up to n does not
+// reallocate. It is only a hint, so a size that cannot be allocated leaves the
+// array as it was.
+Value reserveFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    double count = args[1].asDouble();
+    if (!args[1].isInteger() || count < 0 || count > static_cast<double>(std::vector<Value>().max_size())) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    std::vector<Value>& array = args[0].asArray();
+    try {
+        array.reserve(static_cast<size_t>(count));
+    } catch (const std::bad_alloc&) {
+    } catch (const std::length_error&) {
+    }
+    return Value();
+}
+
+// The math builtins take a number, or an array of numbers and return a new
+// array with the function applied to every element. An array is converted to
+// doubles once and run through a plain loop, without going through a Value
+// per call.
+static double squareRoot(double x) { return std::sqrt(x); }
+static double exponential(double x) { return std::exp(x); }
+static double logarithm(double x) { return std::log(x); }
+static double sine(double x) { return std::sin(x); }
+static double cosine(double x) { return std::cos(x); }
+static double absolute(double x) { return std::fabs(x); }
+static double roundDown(double x) { return std::floor(x); }
+
+// Copies a number, or the elements of an array of numbers, into numbers
+static void numberOperand(const Value& operand, std::vector<double>& numbers) {
+    if (!operand.isArray()) {
+        numbers.push_back(operand.asDouble());
+    } else if (!copyNumbers(operand, numbers)) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+}
+
+template <double (*function)(double)>
+static Value mathFunction(Arguments args) {
+    if (args.size() != 1) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const Value& operand = args[0];
+    if (operand.isMatrix()) {
+        MatrixData result(operand.asMatrix());
+        for (size_t i = 0; i < result.size(); ++i) {
+            result.data()[i] = function(result.data()[i]);
+        }
+        return Value(std::move(result));
+    }
+    if (!operand.isArray()) {
+        return Value(function(operand.asDouble()));
+    }
+    std::vector<double> numbers;
+    numberOperand(operand, numbers);
+    for (double& number : numbers) {
+        number = function(number);
+    }
+    return arrayOfNumbers(numbers);
+}
+
+Value sqrtFunction(Arguments args) { return mathFunction<squareRoot>(args); }
+Value expFunction(Arguments args) { return mathFunction<exponential>(args); }
+Value logFunction(Arguments args) { return mathFunction<logarithm>(args); }
+Value sinFunction(Arguments args) { return mathFunction<sine>(args); }
+Value cosFunction(Arguments args) { return mathFunction<cosine>(args); }
+Value absFunction(Arguments args) { return mathFunction<absolute>(args); }
+Value floorFunction(Arguments args) { return mathFunction<roundDown>(args); }
+
+// pow(x, y): x to the power y. Either side may be an array, and a number on
+// the other side is used for every element; two arrays must have the same
+// size.
+Value powFunction(Arguments args) {
+    if (args.size() != 2) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const Value& base = args[0];
+    const Value& exponent = args[1];
+    if (!base.isArray() && !exponent.isArray()) {
+        return Value(std::pow(base.asDouble(), exponent.asDouble()));
+    }
+    std::vector<double> bases;
+    std::vector<double> exponents;
+    numberOperand(base, bases);
+    numberOperand(exponent, exponents);
+    if (base.isArray() && exponent.isArray() && bases.size() != exponents.size()) {
+        throw std::runtime_error("Runtime error: array sizes differ.");
+    }
+    size_t baseStep = base.isArray() ? 1 : 0;
+    size_t exponentStep = exponent.isArray() ? 1 : 0;
+    std::vector<double> powers;
+    {
+        HeapCategoryScope heap(HeapCategory::Arrays);
+        powers.resize(base.isArray() ? bases.size() : exponents.size());
+    }
+    for (size_t i = 0; i < powers.size(); ++i) {
+        powers[i] = std::pow(bases[i * baseStep], exponents[i * exponentStep]);
+    }
+    return arrayOfNumbers(powers);
+}
+
+// Size of a matrix dimension given by a script: an integer of at least 0
+static size_t matrixDimension(const Value& sizeValue) {
+    double size = sizeValue.asDouble();
+    if (!sizeValue.isInteger() || size < 0 || size > static_cast<double>(std::vector<double>().max_size())) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    return static_cast<size_t>(size);
+}
+
+// matrix(rows) builds a matrix from an array of rows, arrays of numbers of the
+// same length; matrix(r, c) is an r x c matrix of zeros
+Value matrixFunction(Arguments args) {
+    if (args.size() == 2) {
+        size_t rows = matrixDimension(args[0]);
+        size_t columns = matrixDimension(args[1]);
+        if (columns != 0 && rows > std::vector<double>().max_size() / columns) {
+            throw std::runtime_error("Runtime error: invalid operand type.");
+        }
+        try {
+            return Value(MatrixData(rows, columns));
+        } catch (const std::bad_alloc&) {
+            throw std::runtime_error("Runtime error: out of memory.");
+        } catch (const std::length_error&) {
+            throw std::runtime_error("Runtime error: out of memory.");
+        }
+    }
+    if (args.size() != 1) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const Value& rowsValue = args[0];
+    ArrayElements rows = rowsValue.asArray();
+    size_t columns = rows.empty() ? 0 : rows[0].asArray().size();
+    MatrixData matrix(rows.size(), columns);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        ArrayElements row = rows[i].asArray();
+        if (row.size() != columns) {
+            throw std::runtime_error("Runtime error: array sizes differ.");
+        }
+        for (size_t j = 0; j < columns; ++j) {
+            matrix.row(i)[j] = row[j].asDouble();
+        }
+    }
+    return Value(std::move(matrix));
+}
+
+// shape(m): [rows, columns] of a matrix
+Value shapeFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isMatrix()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const MatrixData& matrix = args[0].asMatrix();
+    HeapCategoryScope heap(HeapCategory::Arrays);
+    return Value(std::vector<Value>{Value(static_cast<double>(matrix.rows())),
+                                    Value(static_cast<double>(matrix.columns()))});
+}
+
+// Side of the square blocks matmul and transpose work in. Three blocks of
+// doubles fit in a 256 KB cache.
+static const size_t MatrixBlock = 64;
+
+// Adds rows [first, last) of a * b to product. For each block of a's columns
+// and b's columns, the block of b is reused for every row before moving on.
+// The innermost loop runs along a row of b and of product, contiguously. Each
+// element sums its terms in column order whichever rows a call covers, so
+// splitting the rows over threads does not change the result.
+static void multiplyRows(const MatrixData& a, const MatrixData& b, MatrixData& product, size_t first, size_t last) {
+    size_t inner = a.columns();
+    size_t columns = b.columns();
+    for (size_t kBlock = 0; kBlock < inner; kBlock += MatrixBlock) {
+        size_t kEnd = std::min(kBlock + MatrixBlock, inner);
+        for (size_t jBlock = 0; jBlock < columns; jBlock += MatrixBlock) {
+            size_t jEnd = std::min(jBlock + MatrixBlock, columns);
+            for (size_t i = first; i < last; ++i) {
+                const double* aRow = a.row(i);
+                double* productRow = product.row(i);
+                for (size_t k = kBlock; k < kEnd; ++k) {
+                    double factor = aRow[k];
+                    const double* bRow = b.row(k);
+                    // Four at a time, all loads before the stores, so that the
+                    // compiler turns each group into vector instructions
+                    size_t j = jBlock;
+                    for (; j + 4 <= jEnd; j += 4) {
+                        double sum0 = productRow[j] + factor * bRow[j];
+                        double sum1 = productRow[j + 1] + factor * bRow[j + 1];
+                        double sum2 = productRow[j + 2] + factor * bRow[j + 2];
+                        double sum3 = productRow[j + 3] + factor * bRow[j + 3];
+                        productRow[j] = sum0;
+                        productRow[j + 1] = sum1;
+                        productRow[j + 2] = sum2;
+                        productRow[j + 3] = sum3;
+                    }
+                    for (; j < jEnd; ++j) {
+                        productRow[j] += factor * bRow[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// a * b as matrices, with the rows of the product split into blocks on the
+// work pool when parallel is set
+static Value matrixProduct(Arguments args, bool parallel) {
+    if (args.size() != 2) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const Value& left = args[0];
+    const Value& right = args[1];
+    const MatrixData& a = left.asMatrix();
+    const MatrixData& b = right.asMatrix();
+    if (a.columns() != b.rows()) {
+        throw std::runtime_error("Runtime error: matrix shapes differ.");
+    }
+    MatrixData product(a.rows(), b.columns());
+    size_t blocks = (a.rows() + MatrixBlock - 1) / MatrixBlock;
+    if (parallel && blocks > 1) {
+        WorkPool::shared().parallelFor(blocks, [&a, &b, &product](size_t block) {
+            multiplyRows(a, b, product, block * MatrixBlock, std::min((block + 1) * MatrixBlock, a.rows()));
+        });
+    } else {
+        multiplyRows(a, b, product, 0, a.rows());
+    }
+    return Value(std::move(product));
+}
+
+// matmul(a, b): matrix product; pmatmul(a, b) computes it on the work pool
+Value matmulFunction(Arguments args) {
+    return matrixProduct(args, false);
+}
+
+Value pmatmulFunction(Arguments args) {
+    return matrixProduct(args, true);
+}
+
+// transpose(m): new matrix with the rows and columns of m swapped, copied
+// block by block so that reads and writes both stay within cached lines
+Value transposeFunction(Arguments args) {
+    if (args.size() != 1 || !args[0].isMatrix()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const MatrixData& matrix = args[0].asMatrix();
+    MatrixData result(matrix.columns(), matrix.rows());
+    for (size_t iBlock = 0; iBlock < matrix.rows(); iBlock += MatrixBlock) {
+        size_t iEnd = std::min(iBlock + MatrixBlock, matrix.rows());
+        for (size_t jBlock = 0; jBlock < matrix.columns(); jBlock += MatrixBlock) {
+            size_t jEnd = std::min(jBlock + MatrixBlock, matrix.columns());
+            for (size_t i = iBlock; i < iEnd; ++i) {
+                for (size_t j = jBlock; j < jEnd; ++j) {
+                    result.row(j)[i] = matrix.row(i)[j];
+                }
+            }
+        }
+    }
+    return Value(std::move(result));
+}
+
+// vector() and vector(a): persistent vector, empty or holding the elements of
+// array a
+Value vectorFunction(Arguments args) {
+    if (args.size() == 0) {
+        return Value(VectorData());
+    }
+    const Value& array = args[0];
+    if (args.size() != 1 || !array.isArray()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    return Value(VectorData(array.asArray()));
+}
+
+// assoc(v, i, x): new vector like v with element i set to x
+Value assocFunction(Arguments args) {
+    if (args.size() != 3 || !args[0].isVector()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    const VectorData& vector = args[0].asVector();
+    size_t index = checkedIndex(args[1], vector.size());
+    return Value(vector.assoc(index, std::move(args[2])));
+}
+
+// conj(v, x): new vector like v with x appended
+Value conjFunction(Arguments args) {
+    if (args.size() != 2 || !args[0].isVector()) {
+        throw std::runtime_error("Runtime error: incorrect argument count.");
+    }
+    return Value(args[0].asVector().conj(std::move(args[1])));
+}
+
+// Builtin function values keep the std::vector signature of Value::FunctionPtr
+template <Value (*function)(Arguments)>
+Value builtinAdapter(std::vector<Value>& args) {
+    return function(Arguments(args.data(), args.size()));
+}
+
+void registerBuiltins(std::shared_ptr<Scope> scope) {
+    scope->setVariable("len", Value(Value::FunctionPtr(builtinAdapter<lenFunction>)));
+    scope->setVariable("pop", Value(Value::FunctionPtr(builtinAdapter<popFunction>)));
+    scope->setVariable("push", Value(Value::FunctionPtr(builtinAdapter<pushFunction>)));
+}
+
+// Releases the scopes of a run that closure cycles keep alive when it goes
+// out of scope
+struct RunScopeRelease {
+    RunScopeRelease() = default;
+    RunScopeRelease(const RunScopeRelease&) = delete;
+    RunScopeRelease& operator=(const RunScopeRelease&) = delete;
+    ~RunScopeRelease() { Scope::releaseRunScopes(); }
+};
+
+int runScript(const std::string& source, std::ostream& out) {
+    std::ostream* previousOutput = scriptOutput;
+    scriptOutput = &out;
+    // Declared before the scopes and the AST so that it outlives them
+    static thread_local RunArena arena;
+    RunArenaScope runMemory(arena);
+    // Runs after the scopes and the AST are gone and before the arena resets
+    RunScopeRelease releaseScopes;
+    std::shared_ptr<Scope> globalScope;
+    {
+        HeapCategoryScope heap(HeapCategory::Scopes);
+        globalScope = Scope::create();
+    }
+    registerBuiltins(globalScope);
+    int exitCode = 0;
+
+    try {
+        stats.beginPhase("lex");
+        Lexer lexer(source);
+        std::vector<Token> tokens;
+        {
+            TraceSpan span("frontend", "lex");
+            tokens = lexer.tokenize();
+        }
+        stats.endPhase();
+        stats.addCount("tokens", tokens.size());
+        if (lexer.isSyntaxError(tokens, out)) {
+            scriptOutput = previousOutput;
+            return 1;
+        }
+
+        stats.beginPhase("parse");
+        Parser parser(tokens);
+        std::unique_ptr<ASTNode> ast;
+        {
+            TraceSpan span("frontend", "parse");
+            ast = parser.parse();
+        }
+        stats.endPhase();
+        stats.addCount("AST nodes", countASTNodes(ast.get()));
+
+        if (ast->getType() == ASTNode::Type::BlockNode) {
+            stats.beginPhase("execute");
+            evaluateProgram(static_cast<const BlockNode*>(ast.get()), globalScope);
+            stats.endPhase();
+            if (heapProfiler) {
+                heapProfiler->snapshotLive();
+            }
+        } else {
+            throw std::runtime_error("Invalid AST node type");
+        }
+    } catch (const std::runtime_error& e) {
+        out << e.what() << std::endl;
+        if (std::string(e.what()) == "Runtime error: condition is not a bool.") {
+            exitCode = 3;
+        } else if (std::string(e.what()) == "Runtime error: incorrect argument count.") {
+            exitCode = 3;
+        } else if (std::string(e.what()) == "Runtime error: not a function.") {
+            exitCode = 3;
+        } else {
+            exitCode = 2;
+        }
+    } catch (...){
+        out << "Runtime error: unexpected return." << std::endl;
+        exitCode = 3;
+    }
+    scriptOutput = previousOutput;
+    return exitCode;
+}
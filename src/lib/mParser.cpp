@@ -1,477 +1,646 @@
-
-#include "mParser.h"
-#include <iostream>
-#include <ostream>
-
-// Constructor
-Parser::Parser(const std::vector<Token> &tokens)
-        : tokens(tokens), current(0) {}
-
-// Parse the tokens and return the root node of the AST
-std::unique_ptr<ASTNode> Parser::parse() {
-    std::vector<std::unique_ptr<ASTNode>> statements;
-
-    while (!isAtEnd()) {
-        try {
-            std::unique_ptr<ASTNode> stmt = parseStatement();
-            if (stmt != nullptr) {
-                statements.push_back(std::move(stmt));
-            }
-        } catch (...) {
-            synchronize();
-            throw;
-        }
-    }
-
-    return std::make_unique<BlockNode>(std::move(statements));
-}
-
-
-// Parse function for each rule
-std::unique_ptr<ASTNode> Parser::parseStatement()
-{
-    std::unique_ptr<ASTNode> stmt;   
-    if (match(TokenType::IF))
-    {
-        stmt = parseIfStatement();
-    }
-    else if (match(TokenType::WHILE))
-    {
-        stmt = parseWhileStatement();
-    }
-    else if (match(TokenType::PRINT))
-    {
-        stmt = parsePrintStatement();
-    }
-    else if (match(TokenType::LEFT_BRACE))
-    {
-        stmt = parseBlock();
-    }
-    else if (match(TokenType::DEF)) {
-        return parseFunctionDefinition();
-    }
-    else if (match(TokenType::RETURN)) {
-        return parseReturnStatement();
-    }
-    else
-    {
-        
-        stmt = parseExpressionStatement();
-    }
-    return stmt;
-
-}
-
-// Parses Function Definitions
-std::unique_ptr<ASTNode> Parser::parseFunctionDefinition() {
-    Token name = consume(TokenType::IDENTIFIER);
-    consume(TokenType::LEFT_PAREN);
-
-    std::vector<Token> parameters;
-    if (!check(TokenType::RIGHT_PAREN)) {
-        do {
-            parameters.push_back(consume(TokenType::IDENTIFIER));
-        } while (match(TokenType::COMMA));
-    }
-
-    consume(TokenType::RIGHT_PAREN);
-    std::unique_ptr<ASTNode> body = parseBlock();
-
-    return std::make_unique<FunctionNode>(name, std::move(parameters), std::move(body));
-}
-
-// Parses the Return of Functions
-std::unique_ptr<ASTNode> Parser::parseReturnStatement() {
-    std::unique_ptr<ASTNode> value = nullptr;
-    if (!check(TokenType::SEMICOLON)) {
-        value = parseExpression();
-    }
-    consume(TokenType::SEMICOLON);
-    return std::make_unique<ReturnNode>(std::move(value));
-}
-
-//Parses Function Calls
-std::unique_ptr<ASTNode> Parser::parseCall(std::unique_ptr<ASTNode> callee) {
-    std::vector<std::unique_ptr<ASTNode>> arguments;
-    if (!check(TokenType::RIGHT_PAREN)) {
-        do {
-            arguments.push_back(parseExpression());
-        } while (match(TokenType::COMMA));
-    }
-    consume(TokenType::RIGHT_PAREN);
-    return std::make_unique<CallNode>(std::move(callee), std::move(arguments));
-}
-
-
-// Parses if statements & blocks
-std::unique_ptr<ASTNode> Parser::parseIfStatement()
-{
-    
-    auto condition = parseExpression();
-    
-    auto trueBranch = parseBlock();
-    
-    std::unique_ptr<ASTNode> elseBranch = nullptr;
-    if (match(TokenType::ELSE))
-    {
-        while (match(TokenType::NEWLINE)) {  
-        }
-       
-
-        if (check(TokenType::IF))
-        {
-            advance();
-            elseBranch = parseIfStatement();
-        }
-        else
-        {
-            elseBranch = parseBlock();
-        }
-
-    }
-    return std::make_unique<IfNode>(std::move(condition), std::move(trueBranch), std::move(elseBranch));
-}
-
-// parses while statements and blocks
-std::unique_ptr<ASTNode> Parser::parseWhileStatement()
-{
-    while (match(TokenType::NEWLINE))
-    {
-        // consuming the newline
-
-    }
-
-    auto condition = parseExpression(); 
-   
-    while (match(TokenType::NEWLINE))
-    {
-        //consuming the newline
-
-    }
- 
-    auto body = parseBlock();
-    return std::make_unique<WhileNode>(std::move(condition), std::move(body));
-}
-
-// parses print statements
-std::unique_ptr<ASTNode> Parser::parsePrintStatement() {
-    auto expression = parseExpression();
-    if (peek().type == TokenType::LEFT_PAREN) {
-        advance();
-        expression = parseCall(std::move(expression));
-        if (!match(TokenType::SEMICOLON)) {
-            throw std::runtime_error("Expected ';' after print statement");
-        }
-    } else {
-        if (!match(TokenType::SEMICOLON)) {
-            throw std::runtime_error("Expected ';' after print statement");
-        }
-    }
-
-    return std::make_unique<PrintNode>(std::move(expression));
-}
-
-
-
-// parses block nodes
-std::unique_ptr<ASTNode> Parser::parseBlock()
-{
-    consume(TokenType::LEFT_BRACE);
-    std::vector<std::unique_ptr<ASTNode>> statements;
-
-    while (!check(TokenType::RIGHT_BRACE) && !isAtEnd())
-    {
-        while (match(TokenType::NEWLINE))
-        {
-            //consuming the newline
-        }
-        statements.push_back(parseStatement());
-        
-    }
-
-    consume(TokenType::RIGHT_BRACE);
-    while (match(TokenType::NEWLINE))
-    {
-        //consuming the newline
-    }
-    
-    return std::make_unique<BlockNode>(std::move(statements));
-}
-
-// main parse for expression statements (NOT BLOCKS)
-std::unique_ptr<ASTNode> Parser::parseExpressionStatement()
-{
-    auto expression = parseExpression();
-
-   
-    if (peek().type != TokenType::RIGHT_BRACE && 
-        peek().type != TokenType::ELSE &&
-        !isAtEnd()) {
-        consume(TokenType::SEMICOLON);
-    }
-
-    return expression;
-}
-
-// parse for all expressions
-std::unique_ptr<ASTNode> Parser::parseExpression()
-{
-    return parseAssignment();
-}
-
-// parses assignment
-std::unique_ptr<ASTNode> Parser::parseAssignment() {
-    auto node = parseLogicalOr();
-    if (match(TokenType::ASSIGN)) {
-        auto value = parseAssignment();
-        return std::make_unique<AssignmentNode>(std::move(node), std::move(value));
-    }
-    return node;
-}
-
-
-std::unique_ptr<ASTNode> Parser::parseArrayLiteral() {
-    std::vector<std::unique_ptr<ASTNode>> elements;
-    if (!check(TokenType::RBRACK)) {
-        do {
-            elements.push_back(parseExpression());
-        } while (match(TokenType::COMMA));
-    }
-
-    consume(TokenType::RBRACK);
-    return std::make_unique<ArrayLiteralNode>(std::move(elements));
-}
-
-
-std::unique_ptr<ASTNode> Parser::parseArrayLookup(std::unique_ptr<ASTNode> array) {
-    auto index = parseExpression();
-    consume(TokenType::RBRACK);
-    
-    return std::make_unique<ArrayLookupNode>(std::move(array), std::move(index));
-}
-
-std::unique_ptr<ASTNode> Parser::parsePrimary() {
-    std::unique_ptr<ASTNode> node;
-
-    if (match(TokenType::NUMBER)) {
-        node = std::make_unique<NumberNode>(previous());
-    }  else if (match(TokenType::NULL_TOKEN)) {
-        return std::make_unique<NullNode>();
-    }
-    else if (match(TokenType::LEFT_PAREN)) {
-        node = parseExpression();
-        consume(TokenType::RIGHT_PAREN);
-    } else if (match(TokenType::LBRACK)) {
-        node = parseArrayLiteral();
-    } else if (match(TokenType::IDENTIFIER) || match(TokenType::PUSH) || match(TokenType::POP) || match(TokenType::LEN)) {
-        Token identifier = previous();
-        if (check(TokenType::LEFT_PAREN)) {
-            advance();
-            node = parseCall(std::make_unique<VariableNode>(identifier));
-        } else {
-            node = std::make_unique<VariableNode>(identifier);
-        }
-    } else if (match(TokenType::BOOLEAN_TRUE) || match(TokenType::BOOLEAN_FALSE) || match(TokenType::NULL_TOKEN)) {
-        node = std::make_unique<BooleanNode>(previous());
-    } else {
-        throw std::runtime_error("Unexpected token at line " + std::to_string(tokens[current].line) + " column " + std::to_string(tokens[current].column) + ": " + tokens[current].value);
-    }
-
-    while (check(TokenType::LBRACK)) {
-        advance();
-        auto index = parseExpression();
-        consume(TokenType::RBRACK);
-        node = std::make_unique<ArrayLookupNode>(std::move(node), std::move(index));
-    }
-
-    return node;
-}
-
-
-/* From here to parse primary, each function parses each type of logical operation or expresion. 
-It is coded to use precedence from track A
-*/
-std::unique_ptr<ASTNode> Parser::parseLogicalOr() {
-    try {
-        auto node = parseLogicalXor();
-        while (match(TokenType::LOGICAL_OR)) {
-            Token op = previous();
-            auto right = parseLogicalXor();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalXor() {
-    try {
-        auto node = parseLogicalAnd();
-        while (match(TokenType::LOGICAL_XOR)) {
-            Token op = previous();
-            auto right = parseLogicalAnd();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalAnd() {
-    try {
-        auto node = parseEquality();
-        while (match(TokenType::LOGICAL_AND)) {
-            Token op = previous();
-            auto right = parseEquality();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-std::unique_ptr<ASTNode> Parser::parseEquality() {
-    try {
-        auto node = parseComparison();
-        while (match(TokenType::EQUAL) || match(TokenType::NOT_EQUAL)) {
-            Token op = previous();
-            auto right = parseComparison();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-std::unique_ptr<ASTNode> Parser::parseAddition() {
-    try {
-        auto node = parseMultiplication();
-        while (match(TokenType::ADD) || match(TokenType::SUBTRACT)) {
-            Token op = previous();
-            auto right = parseMultiplication();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-std::unique_ptr<ASTNode> Parser::parseComparison() {
-    try {
-        auto node = parseAddition();
-        while (match(TokenType::LESS) || match(TokenType::LESS_EQUAL) ||
-               match(TokenType::GREATER) || match(TokenType::GREATER_EQUAL)) {
-            Token op = previous();
-            auto right = parseAddition();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-std::unique_ptr<ASTNode> Parser::parseMultiplication() {
-    try {
-        auto node = parsePrimary();
-        while (match(TokenType::MULTIPLY) || match(TokenType::DIVIDE) || match(TokenType::MODULO)) {
-            Token op = previous();
-            auto right = parsePrimary();
-            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
-        }
-        return node;
-    } catch (...) {
-        throw;
-    }
-}
-
-
-
-//Retrieves the current token without advancing the parser
-const Token &Parser::peek() const
-{
-    if (isAtEnd())
-    {
-        static const Token eofToken(TokenType::END, "END", tokens[current].line, tokens[current].column); 
-        return eofToken;
-    }
-    return tokens[current];
-}
-
-// Advances the parser until a stopping point of a newline
-void Parser::synchronize()
-{
-    advance();
-    while (!isAtEnd())
-    {
-        if (previous().type == TokenType::NEWLINE)
-            return;
-        switch (peek().type)
-        {
-        
-        case TokenType::IF:
-        case TokenType::WHILE:
-        case TokenType::PRINT:
-            return;
-        default:
-            advance();
-        }
-    }
-}
-
-//Checks and advances if the current token matches the given type
-bool Parser::match(TokenType type)
-{
-    if (check(type))
-    {
-        advance();
-        return true;
-    }
-    return false;
-}
-
-//Retrieves the previous token
-Token Parser::previous()
-{
-    return tokens.at(current - 1);
-}
-
-//Consumes a token of the given type
-Token Parser::consume(TokenType type)
-{
-    if (check(type)) 
-        return advance();
-    throw std::runtime_error("Unexpected token at line " + std::to_string(tokens[current].line) + " column " + std::to_string(tokens[current].column) + ": " + tokens[current].value);
-}
-
-//Checks if the current token is of the given type.
-bool Parser::check(TokenType type) const
-{
-    if (isAtEnd())
-        return false;
-    return tokens.at(current).type == type;
-}
-
-//Advances to the next token
-Token Parser::advance()
-{
-    if (!isAtEnd())
-        current++;
-
-    
-    Token token = previous();
-
-    
-    return token;
-}
-
-//Checks if the parser has reached the end of the tokens.
-bool Parser::isAtEnd() const
-{
-    return current >= tokens.size() || tokens.at(current).type == TokenType::END;
-}
\ No newline at end of file
+
+#include "mParser.h"
+#include "Stats.h"
+#include <iostream>
+#include <ostream>
+
+// Constructor
+Parser::Parser(const std::vector<Token> &tokens)
+        : tokens(tokens), current(0) {}
+
+// Parse the tokens and return the root node of the AST
+std::unique_ptr<ASTNode> Parser::parse() {
+    HeapCategoryScope heap(HeapCategory::AST);
+    std::vector<std::unique_ptr<ASTNode>> statements;
+
+    while (!isAtEnd()) {
+        try {
+            std::unique_ptr<ASTNode> stmt = parseStatement();
+            if (stmt != nullptr) {
+                statements.push_back(std::move(stmt));
+            }
+        } catch (...) {
+            synchronize();
+            throw;
+        }
+    }
+
+    return std::make_unique<BlockNode>(std::move(statements));
+}
+
+
+// Parse function for each rule
+std::unique_ptr<ASTNode> Parser::parseStatement()
+{
+    const Token& start = peek();
+    int line = start.line;
+    int column = start.column;
+    std::unique_ptr<ASTNode> stmt;   
+    if (match(TokenType::IF))
+    {
+        stmt = parseIfStatement();
+    }
+    else if (match(TokenType::WHILE))
+    {
+        stmt = parseWhileStatement();
+    }
+    else if (match(TokenType::PRINT))
+    {
+        stmt = parsePrintStatement();
+    }
+    else if (match(TokenType::LEFT_BRACE))
+    {
+        stmt = parseBlock();
+    }
+    else if (match(TokenType::DEF)) {
+        stmt = parseFunctionDefinition();
+    }
+    else if (match(TokenType::STRUCT)) {
+        stmt = parseStructDefinition();
+    }
+    else if (match(TokenType::RETURN)) {
+        stmt = parseReturnStatement();
+    }
+    else
+    {
+        
+        stmt = parseExpressionStatement();
+    }
+    if (stmt) {
+        stmt->line = line;
+        stmt->column = column;
+    }
+    return stmt;
+
+}
+
+// Parses Function Definitions
+std::unique_ptr<ASTNode> Parser::parseFunctionDefinition() {
+    Token name = consume(TokenType::IDENTIFIER);
+    consume(TokenType::LEFT_PAREN);
+
+    std::vector<Token> parameters;
+    if (!check(TokenType::RIGHT_PAREN)) {
+        do {
+            parameters.push_back(consume(TokenType::IDENTIFIER));
+        } while (match(TokenType::COMMA));
+    }
+
+    consume(TokenType::RIGHT_PAREN);
+    std::unique_ptr<ASTNode> body = parseBlock();
+
+    return std::make_unique<FunctionNode>(name, std::move(parameters), std::move(body));
+}
+
+// Parses struct Name { field, ... } after the keyword. A field may only be
+// listed once.
+std::unique_ptr<ASTNode> Parser::parseStructDefinition() {
+    Token name = consume(TokenType::IDENTIFIER);
+    consume(TokenType::LEFT_BRACE);
+
+    std::vector<Token> fields;
+    if (!check(TokenType::RIGHT_BRACE)) {
+        do {
+            Token field = consume(TokenType::IDENTIFIER);
+            for (const Token& earlier : fields) {
+                if (earlier.value == field.value) {
+                    throw std::runtime_error("Unexpected token at line " + std::to_string(field.line) + " column " + std::to_string(field.column) + ": " + field.value);
+                }
+            }
+            fields.push_back(field);
+        } while (match(TokenType::COMMA));
+    }
+
+    consume(TokenType::RIGHT_BRACE);
+    return std::make_unique<StructNode>(name, std::move(fields));
+}
+
+// Parses the Return of Functions
+std::unique_ptr<ASTNode> Parser::parseReturnStatement() {
+    std::unique_ptr<ASTNode> value = nullptr;
+    if (!check(TokenType::SEMICOLON)) {
+        value = parseExpression();
+    }
+    consume(TokenType::SEMICOLON);
+    return std::make_unique<ReturnNode>(std::move(value));
+}
+
+//Parses Function Calls
+std::unique_ptr<ASTNode> Parser::parseCall(std::unique_ptr<ASTNode> callee) {
+    std::vector<std::unique_ptr<ASTNode>> arguments;
+    if (!check(TokenType::RIGHT_PAREN)) {
+        do {
+            arguments.push_back(parseExpression());
+        } while (match(TokenType::COMMA));
+    }
+    consume(TokenType::RIGHT_PAREN);
+    int line = 0;
+    int column = 0;
+    if (callee->getType() == ASTNode::Type::VariableNode) {
+        const Token& identifier = static_cast<const VariableNode*>(callee.get())->identifier;
+        line = identifier.line;
+        column = identifier.column;
+    }
+    auto call = std::make_unique<CallNode>(std::move(callee), std::move(arguments));
+    call->line = line;
+    call->column = column;
+    return call;
+}
+
+
+// Parses if statements & blocks
+std::unique_ptr<ASTNode> Parser::parseIfStatement()
+{
+    Token keyword = previous();
+    auto condition = parseExpression();
+    
+    auto trueBranch = parseBlock();
+    
+    std::unique_ptr<ASTNode> elseBranch = nullptr;
+    if (match(TokenType::ELSE))
+    {
+        while (match(TokenType::NEWLINE)) {  
+        }
+       
+
+        if (check(TokenType::IF))
+        {
+            advance();
+            elseBranch = parseIfStatement();
+        }
+        else
+        {
+            elseBranch = parseBlock();
+        }
+
+    }
+    auto ifNode = std::make_unique<IfNode>(std::move(condition), std::move(trueBranch), std::move(elseBranch));
+    ifNode->line = keyword.line;
+    ifNode->column = keyword.column;
+    return ifNode;
+}
+
+// parses while statements and blocks
+std::unique_ptr<ASTNode> Parser::parseWhileStatement()
+{
+    while (match(TokenType::NEWLINE))
+    {
+        // consuming the newline
+
+    }
+
+    auto condition = parseExpression(); 
+   
+    while (match(TokenType::NEWLINE))
+    {
+        //consuming the newline
+
+    }
+ 
+    auto body = parseBlock();
+    return std::make_unique<WhileNode>(std::move(condition), std::move(body));
+}
+
+// parses print statements
+std::unique_ptr<ASTNode> Parser::parsePrintStatement() {
+    auto expression = parseExpression();
+    if (peek().type == TokenType::LEFT_PAREN) {
+        advance();
+        expression = parseCall(std::move(expression));
+        if (!match(TokenType::SEMICOLON)) {
+            throw std::runtime_error("Expected ';' after print statement");
+        }
+    } else {
+        if (!match(TokenType::SEMICOLON)) {
+            throw std::runtime_error("Expected ';' after print statement");
+        }
+    }
+
+    return std::make_unique<PrintNode>(std::move(expression));
+}
+
+
+
+// parses block nodes
+std::unique_ptr<ASTNode> Parser::parseBlock()
+{
+    Token brace = consume(TokenType::LEFT_BRACE);
+    std::vector<std::unique_ptr<ASTNode>> statements;
+
+    while (!check(TokenType::RIGHT_BRACE) && !isAtEnd())
+    {
+        while (match(TokenType::NEWLINE))
+        {
+            //consuming the newline
+        }
+        statements.push_back(parseStatement());
+        
+    }
+
+    consume(TokenType::RIGHT_BRACE);
+    while (match(TokenType::NEWLINE))
+    {
+        //consuming the newline
+    }
+    
+    auto block = std::make_unique<BlockNode>(std::move(statements));
+    block->line = brace.line;
+    block->column = brace.column;
+    return block;
+}
+
+// main parse for expression statements (NOT BLOCKS)
+std::unique_ptr<ASTNode> Parser::parseExpressionStatement()
+{
+    auto expression = parseExpression();
+
+   
+    if (peek().type != TokenType::RIGHT_BRACE && 
+        peek().type != TokenType::ELSE &&
+        !isAtEnd()) {
+        consume(TokenType::SEMICOLON);
+    }
+
+    return expression;
+}
+
+// parse for all expressions
+std::unique_ptr<ASTNode> Parser::parseExpression()
+{
+    return parseAssignment();
+}
+
+// parses assignment
+std::unique_ptr<ASTNode> Parser::parseAssignment() {
+    auto node = parseLogicalOr();
+    if (match(TokenType::ASSIGN)) {
+        auto value = parseAssignment();
+        return std::make_unique<AssignmentNode>(std::move(node), std::move(value));
+    }
+    return node;
+}
+
+
+std::unique_ptr<ASTNode> Parser::parseArrayLiteral() {
+    std::vector<std::unique_ptr<ASTNode>> elements;
+    if (!check(TokenType::RBRACK)) {
+        do {
+            elements.push_back(parseExpression());
+        } while (match(TokenType::COMMA));
+    }
+
+    consume(TokenType::RBRACK);
+    return std::make_unique<ArrayLiteralNode>(std::move(elements));
+}
+
+
+// Parses {key: value, ...} after the opening brace
+std::unique_ptr<ASTNode> Parser::parseMapLiteral() {
+    std::vector<std::unique_ptr<ASTNode>> keys;
+    std::vector<std::unique_ptr<ASTNode>> values;
+    if (!check(TokenType::RIGHT_BRACE)) {
+        do {
+            keys.push_back(parseExpression());
+            consume(TokenType::COLON);
+            values.push_back(parseExpression());
+        } while (match(TokenType::COMMA));
+    }
+
+    consume(TokenType::RIGHT_BRACE);
+    return std::make_unique<MapLiteralNode>(std::move(keys), std::move(values));
+}
+
+
+// Parses a[index] or a[begin:end] after the opening bracket; either bound
+// of a slice may be omitted
+std::unique_ptr<ASTNode> Parser::parseArrayLookup(std::unique_ptr<ASTNode> array) {
+    std::unique_ptr<ASTNode> index;
+    if (!check(TokenType::COLON)) {
+        index = parseExpression();
+    }
+    if (match(TokenType::COLON)) {
+        std::unique_ptr<ASTNode> end;
+        if (!check(TokenType::RBRACK)) {
+            end = parseExpression();
+        }
+        consume(TokenType::RBRACK);
+        return std::make_unique<SliceNode>(std::move(array), std::move(index), std::move(end));
+    }
+    consume(TokenType::RBRACK);
+    
+    return std::make_unique<ArrayLookupNode>(std::move(array), std::move(index));
+}
+
+std::unique_ptr<ASTNode> Parser::parsePrimary() {
+    std::unique_ptr<ASTNode> node;
+
+    if (match(TokenType::NUMBER)) {
+        node = std::make_unique<NumberNode>(previous());
+    } else if (match(TokenType::STRING)) {
+        node = std::make_unique<StringNode>(previous());
+    } else if (match(TokenType::NULL_TOKEN)) {
+        return std::make_unique<NullNode>();
+    }
+    else if (match(TokenType::LEFT_PAREN)) {
+        node = parseExpression();
+        consume(TokenType::RIGHT_PAREN);
+    } else if (match(TokenType::LBRACK)) {
+        node = parseArrayLiteral();
+    } else if (match(TokenType::LEFT_BRACE)) {
+        node = parseMapLiteral();
+    } else if (match(TokenType::IDENTIFIER) || match(TokenType::PUSH) || match(TokenType::POP) || match(TokenType::LEN)) {
+        Token identifier = previous();
+        if (check(TokenType::LEFT_PAREN)) {
+            advance();
+            node = parseCall(std::make_unique<VariableNode>(identifier));
+        } else {
+            node = std::make_unique<VariableNode>(identifier);
+        }
+    } else if (match(TokenType::BOOLEAN_TRUE) || match(TokenType::BOOLEAN_FALSE) || match(TokenType::NULL_TOKEN)) {
+        node = std::make_unique<BooleanNode>(previous());
+    } else {
+        throw std::runtime_error("Unexpected token at line " + std::to_string(tokens[current].line) + " column " + std::to_string(tokens[current].column) + ": " + tokens[current].value);
+    }
+
+    while (check(TokenType::LBRACK) || check(TokenType::DOT)) {
+        if (match(TokenType::DOT)) {
+            node = std::make_unique<FieldNode>(std::move(node), consume(TokenType::IDENTIFIER));
+            continue;
+        }
+        advance();
+        node = parseArrayLookup(std::move(node));
+    }
+
+    return node;
+}
+
+
+/* From here to parse primary, each function parses each type of logical operation or expresion. 
+It is coded to use precedence from track A
+*/
+std::unique_ptr<ASTNode> Parser::parseLogicalOr() {
+    try {
+        auto node = parseLogicalXor();
+        while (match(TokenType::LOGICAL_OR)) {
+            Token op = previous();
+            auto right = parseLogicalXor();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+std::unique_ptr<ASTNode> Parser::parseLogicalXor() {
+    try {
+        auto node = parseLogicalAnd();
+        while (match(TokenType::LOGICAL_XOR)) {
+            Token op = previous();
+            auto right = parseLogicalAnd();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+std::unique_ptr<ASTNode> Parser::parseLogicalAnd() {
+    try {
+        auto node = parseEquality();
+        while (match(TokenType::LOGICAL_AND)) {
+            Token op = previous();
+            auto right = parseEquality();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+std::unique_ptr<ASTNode> Parser::parseEquality() {
+    try {
+        auto node = parseComparison();
+        while (match(TokenType::EQUAL) || match(TokenType::NOT_EQUAL)) {
+            Token op = previous();
+            auto right = parseComparison();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+std::unique_ptr<ASTNode> Parser::parseAddition() {
+    try {
+        auto node = parseMultiplication();
+        while (match(TokenType::ADD) || match(TokenType::SUBTRACT)) {
+            Token op = previous();
+            auto right = parseMultiplication();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+std::unique_ptr<ASTNode> Parser::parseComparison() {
+    try {
+        auto node = parseAddition();
+        while (match(TokenType::LESS) || match(TokenType::LESS_EQUAL) ||
+               match(TokenType::GREATER) || match(TokenType::GREATER_EQUAL)) {
+            Token op = previous();
+            auto right = parseAddition();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+std::unique_ptr<ASTNode> Parser::parseMultiplication() {
+    try {
+        auto node = parsePrimary();
+        while (match(TokenType::MULTIPLY) || match(TokenType::DIVIDE) || match(TokenType::MODULO)) {
+            Token op = previous();
+            auto right = parsePrimary();
+            node = std::make_unique<BinaryOpNode>(op, std::move(node), std::move(right));
+        }
+        return node;
+    } catch (...) {
+        throw;
+    }
+}
+
+
+
+//Retrieves the current token without advancing the parser
+const Token &Parser::peek() const
+{
+    if (isAtEnd())
+    {
+        static const Token eofToken(TokenType::END, "END", tokens[current].line, tokens[current].column); 
+        return eofToken;
+    }
+    return tokens[current];
+}
+
+// Advances the parser until a stopping point of a newline
+void Parser::synchronize()
+{
+    advance();
+    while (!isAtEnd())
+    {
+        if (previous().type == TokenType::NEWLINE)
+            return;
+        switch (peek().type)
+        {
+        
+        case TokenType::IF:
+        case TokenType::WHILE:
+        case TokenType::PRINT:
+            return;
+        default:
+            advance();
+        }
+    }
+}
+
+//Checks and advances if the current token matches the given type
+bool Parser::match(TokenType type)
+{
+    if (check(type))
+    {
+        advance();
+        return true;
+    }
+    return false;
+}
+
+//Retrieves the previous token
+Token Parser::previous()
+{
+    return tokens.at(current - 1);
+}
+
+//Consumes a token of the given type
+Token Parser::consume(TokenType type)
+{
+    if (check(type)) 
+        return advance();
+    throw std::runtime_error("Unexpected token at line " + std::to_string(tokens[current].line) + " column " + std::to_string(tokens[current].column) + ": " + tokens[current].value);
+}
+
+//Checks if the current token is of the given type.
+bool Parser::check(TokenType type) const
+{
+    if (isAtEnd())
+        return false;
+    return tokens.at(current).type == type;
+}
+
+//Advances to the next token
+Token Parser::advance()
+{
+    if (!isAtEnd())
+        current++;
+
+    
+    Token token = previous();
+
+    
+    return token;
+}
+
+//Checks if the parser has reached the end of the tokens.
+bool Parser::isAtEnd() const
+{
+    return current >= tokens.size() || tokens.at(current).type == TokenType::END;
+}
+
+// Counts the nodes of an AST by walking every child pointer
+size_t countASTNodes(const ASTNode* node) {
+    if (!node) {
+        return 0;
+    }
+    size_t count = 1;
+    switch (node->getType()) {
+        case ASTNode::Type::BinaryOpNode: {
+            auto binaryOpNode = static_cast<const BinaryOpNode*>(node);
+            count += countASTNodes(binaryOpNode->left.get()) + countASTNodes(binaryOpNode->right.get());
+            break;
+        }
+        case ASTNode::Type::AssignmentNode: {
+            auto assignmentNode = static_cast<const AssignmentNode*>(node);
+            count += countASTNodes(assignmentNode->lhs.get()) + countASTNodes(assignmentNode->rhs.get());
+            break;
+        }
+        case ASTNode::Type::PrintNode:
+            count += countASTNodes(static_cast<const PrintNode*>(node)->expression.get());
+            break;
+        case ASTNode::Type::IfNode: {
+            auto ifNode = static_cast<const IfNode*>(node);
+            count += countASTNodes(ifNode->condition.get()) + countASTNodes(ifNode->trueBranch.get()) +
+                     countASTNodes(ifNode->falseBranch.get());
+            break;
+        }
+        case ASTNode::Type::WhileNode: {
+            auto whileNode = static_cast<const WhileNode*>(node);
+            count += countASTNodes(whileNode->condition.get()) + countASTNodes(whileNode->body.get());
+            break;
+        }
+        case ASTNode::Type::BlockNode:
+            for (const auto& stmt : static_cast<const BlockNode*>(node)->statements) {
+                count += countASTNodes(stmt.get());
+            }
+            break;
+        case ASTNode::Type::FunctionNode:
+            count += countASTNodes(static_cast<const FunctionNode*>(node)->body.get());
+            break;
+        case ASTNode::Type::ReturnNode:
+            count += countASTNodes(static_cast<const ReturnNode*>(node)->value.get());
+            break;
+        case ASTNode::Type::CallNode: {
+            auto callNode = static_cast<const CallNode*>(node);
+            count += countASTNodes(callNode->callee.get());
+            for (const auto& arg : callNode->arguments) {
+                count += countASTNodes(arg.get());
+            }
+            break;
+        }
+        case ASTNode::Type::ArrayLiteralNode:
+            for (const auto& element : static_cast<const ArrayLiteralNode*>(node)->elements) {
+                count += countASTNodes(element.get());
+            }
+            break;
+        case ASTNode::Type::ArrayLookupNode: {
+            auto arrayLookupNode = static_cast<const ArrayLookupNode*>(node);
+            count += countASTNodes(arrayLookupNode->array.get()) + countASTNodes(arrayLookupNode->index.get());
+            break;
+        }
+        case ASTNode::Type::SliceNode: {
+            auto sliceNode = static_cast<const SliceNode*>(node);
+            count += countASTNodes(sliceNode->array.get()) + countASTNodes(sliceNode->begin.get()) +
+                     countASTNodes(sliceNode->end.get());
+            break;
+        }
+        case ASTNode::Type::MapLiteralNode: {
+            auto mapLiteralNode = static_cast<const MapLiteralNode*>(node);
+            for (size_t i = 0; i < mapLiteralNode->keys.size(); ++i) {
+                count += countASTNodes(mapLiteralNode->keys[i].get()) + countASTNodes(mapLiteralNode->values[i].get());
+            }
+            break;
+        }
+        case ASTNode::Type::FieldNode:
+            count += countASTNodes(static_cast<const FieldNode*>(node)->record.get());
+            break;
+        default:
+            break;
+    }
+    return count;
+}
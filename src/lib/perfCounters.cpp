@@ -0,0 +1,100 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    for (int i = 0; i < Count; ++i) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+PerfSample PerfSample::operator-(const PerfSample& other) const {
+    PerfSample difference;
+    for (int i = 0; i < Count; ++i) {
+        difference.values[i] = values[i] - other.values[i];
+    }
+    return difference;
+}
+
+const char* PerfCounters::name(int counter) {
+    static const char* names[PerfSample::Count] = {
+        "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"
+    };
+    return names[counter];
+}
+
+#ifdef __linux__
+
+// Opens one user-space counter for the calling process on any CPU
+static int openCounter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+bool PerfCounters::open() {
+    const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+                                 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds[0] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[1] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[2] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds[3] = openCounter(PERF_TYPE_HW_CACHE, l1dReadMiss);
+    fds[4] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    return anyAvailable();
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+PerfSample PerfCounters::read() const {
+    PerfSample sample;
+    for (int i = 0; i < PerfSample::Count; ++i) {
+        uint64_t value = 0;
+        if (fds[i] >= 0 && ::read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+            sample.values[i] = value;
+        }
+    }
+    return sample;
+}
+
+#else
+
+// Hardware counters are only supported on Linux
+bool PerfCounters::open() {
+    return false;
+}
+
+PerfCounters::~PerfCounters() {}
+
+PerfSample PerfCounters::read() const {
+    return PerfSample();
+}
+
+#endif
+
+bool PerfCounters::anyAvailable() const {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
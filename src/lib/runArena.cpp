@@ -0,0 +1,64 @@
+#include "RunArena.h"
+#include "Stats.h"
+
+thread_local RunArena* runArena = nullptr;
+
+RunArena::~RunArena() {
+    for (char* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+}
+
+void* RunArena::allocate(size_t size) {
+    if (size == 0 || size > MaxBlockSize) {
+        return ::operator new(size);
+    }
+    size_t sizeClass = (size - 1) / Granularity;
+    size_t blockSize = (sizeClass + 1) * Granularity;
+    used += blockSize;
+    if (FreeBlock* block = freeLists[sizeClass]) {
+        freeLists[sizeClass] = block->next;
+        return block;
+    }
+    if (static_cast<size_t>(end - next) < blockSize) {
+        // The tail of the old chunk is abandoned until the next reset
+        if (next && currentChunk + 1 < chunks.size()) {
+            ++currentChunk;
+        } else {
+            HeapCategoryScope heap(HeapCategory::Arena);
+            chunks.push_back(static_cast<char*>(::operator new(ChunkSize)));
+            currentChunk = chunks.size() - 1;
+        }
+        next = chunks[currentChunk];
+        end = next + ChunkSize;
+    }
+    void* block = next;
+    next += blockSize;
+    return block;
+}
+
+void RunArena::deallocate(void* block, size_t size) {
+    if (size == 0 || size > MaxBlockSize) {
+        ::operator delete(block);
+        return;
+    }
+    size_t sizeClass = (size - 1) / Granularity;
+    used -= (sizeClass + 1) * Granularity;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeLists[sizeClass];
+    freeLists[sizeClass] = freed;
+}
+
+void RunArena::reset() {
+    while (chunks.size() > MaxKeptChunks) {
+        ::operator delete(chunks.back());
+        chunks.pop_back();
+    }
+    for (FreeBlock*& head : freeLists) {
+        head = nullptr;
+    }
+    currentChunk = 0;
+    next = chunks.empty() ? nullptr : chunks[0];
+    end = chunks.empty() ? nullptr : chunks[0] + ChunkSize;
+    used = 0;
+}
@@ -0,0 +1,455 @@
+#include "Stats.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <sys/resource.h>
+
+Stats stats;
+
+static std::atomic<bool> heapAccounting(false);
+static std::atomic<uint64_t> allocations(0);
+static std::atomic<uint64_t> allocatedBytes(0);
+
+thread_local HeapCategory activeHeapCategory = HeapCategory::Other;
+
+static const int CategoryCount = static_cast<int>(HeapCategory::Count);
+
+struct CategoryCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> live{0};
+    std::atomic<uint64_t> peak{0};
+};
+
+static CategoryCounters categoryCounters[CategoryCount];
+static std::atomic<uint64_t> liveBytes(0);
+static std::atomic<uint64_t> peakBytes(0);
+
+// Prefix of every block; 16 bytes keeps the returned pointer aligned for any
+// fundamental type. Blocks allocated while accounting is off have category
+// Uncounted.
+struct alignas(16) BlockHeader {
+    uint64_t size;
+    uint32_t category;
+    uint32_t site;
+};
+
+static const uint32_t Uncounted = ~0u;
+
+void enableHeapAccounting() {
+    heapAccounting.store(true, std::memory_order_relaxed);
+}
+
+bool heapAccountingEnabled() {
+    return heapAccounting.load(std::memory_order_relaxed);
+}
+
+static AllocationSampler allocationSampler = nullptr;
+static SampledRelease sampledRelease = nullptr;
+static double sampleMeanBytes = 0;
+// The sampling state belongs to the thread that installed the sampler. The
+// heap profiler is not thread-safe, so allocations and frees on other
+// threads, such as those of the work pool, are never sampled or released.
+static thread_local bool samplerThread = false;
+static thread_local double bytesUntilSample = 0;
+static thread_local bool sampling = false;
+static thread_local uint64_t sampleRandom = 0x9E3779B97F4A7C15ull;
+
+// Exponentially distributed distance to the next sample, so that allocation
+// patterns cannot line up with a fixed sampling period
+static double nextSampleDistance() {
+    sampleRandom ^= sampleRandom << 13;
+    sampleRandom ^= sampleRandom >> 7;
+    sampleRandom ^= sampleRandom << 17;
+    double uniform = (static_cast<double>(sampleRandom >> 11) + 0.5) / 9007199254740992.0;
+    return -std::log(uniform) * sampleMeanBytes;
+}
+
+void setAllocationSampler(AllocationSampler sampler, SampledRelease release, uint64_t sampleBytes) {
+    if (sampler) {
+        enableHeapAccounting();
+    }
+    sampleMeanBytes = static_cast<double>(sampleBytes ? sampleBytes : 1);
+    samplerThread = sampler != nullptr;
+    bytesUntilSample = nextSampleDistance();
+    allocationSampler = sampler;
+    sampledRelease = release;
+}
+
+static void raisePeak(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Counting replacement of the global allocator. Array and nothrow forms
+// forward to these by default.
+void* operator new(std::size_t size) {
+    BlockHeader* header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+    if (!header) {
+        throw std::bad_alloc();
+    }
+    header->size = size;
+    header->site = 0;
+    if (!heapAccounting.load(std::memory_order_relaxed)) {
+        header->category = Uncounted;
+        return header + 1;
+    }
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    int category = static_cast<int>(activeHeapCategory);
+    header->category = category;
+    if (samplerThread && allocationSampler && !sampling) {
+        bytesUntilSample -= static_cast<double>(size);
+        if (bytesUntilSample < 0) {
+            // The sampler allocates itself; those allocations are not sampled
+            sampling = true;
+            header->site = allocationSampler(static_cast<HeapCategory>(category), size);
+            sampling = false;
+            bytesUntilSample = nextSampleDistance();
+        }
+    }
+    CategoryCounters& counters = categoryCounters[category];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    raisePeak(counters.peak, counters.live.fetch_add(size, std::memory_order_relaxed) + size);
+    raisePeak(peakBytes, liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    return header + 1;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (header->category == Uncounted) {
+        std::free(header);
+        return;
+    }
+    if (header->site && samplerThread && sampledRelease) {
+        sampledRelease(header->site, header->size);
+    }
+    categoryCounters[header->category].live.fetch_sub(header->size, std::memory_order_relaxed);
+    liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t allocationBytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+const char* heapCategoryName(HeapCategory category) {
+    static const char* names[CategoryCount] = {
+        "other", "tokens", "ast", "values", "arrays", "scopes", "closures", "arena", "strings"
+    };
+    return names[static_cast<int>(category)];
+}
+
+HeapUsage heapUsage(HeapCategory category) {
+    const CategoryCounters& counters = categoryCounters[static_cast<int>(category)];
+    HeapUsage usage;
+    usage.allocations = counters.allocations.load(std::memory_order_relaxed);
+    usage.bytes = counters.bytes.load(std::memory_order_relaxed);
+    usage.liveBytes = counters.live.load(std::memory_order_relaxed);
+    usage.peakBytes = counters.peak.load(std::memory_order_relaxed);
+    return usage;
+}
+
+uint64_t liveHeapBytes() {
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t peakHeapBytes() {
+    return peakBytes.load(std::memory_order_relaxed);
+}
+
+void resetHeapPeaks() {
+    for (CategoryCounters& counters : categoryCounters) {
+        counters.peak.store(counters.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// User plus system CPU time of the process in milliseconds
+static double cpuTimeMs() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+// Peak resident set size in kilobytes
+static long peakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void writeStatsAtExit() {
+    std::cout.flush();
+    stats.write(std::cerr);
+}
+
+bool Stats::parseOption(const std::string& arg) {
+    if (arg == "--stats" || arg == "--stats=json" || arg == "--stats=text") {
+        json = arg == "--stats=json";
+        enable();
+        return true;
+    }
+    if (arg == "--perf" || arg == "--perf=functions") {
+        if (!perfEnabled) {
+            perfEnabled = true;
+            if (!perf.open()) {
+                std::cerr << "Hardware counters are unavailable; --perf reports timing only." << std::endl;
+            }
+        }
+        perfFunctions = perfFunctions || arg == "--perf=functions";
+        enable();
+        return true;
+    }
+    return false;
+}
+
+void Stats::enable() {
+    if (!active) {
+        active = true;
+        enableHeapAccounting();
+        // Tools exit from many places (including inside the parsers), so the
+        // report is written from an exit handler
+        std::atexit(writeStatsAtExit);
+    }
+}
+
+PhaseStats& Stats::phase(const std::string& name) {
+    for (auto& existing : phases) {
+        if (existing.name == name) {
+            return existing;
+        }
+    }
+    phases.push_back(PhaseStats());
+    phases.back().name = name;
+    return phases.back();
+}
+
+void Stats::beginPhase(const std::string& name) {
+    if (!active) {
+        return;
+    }
+    if (!currentPhase.empty()) {
+        endPhase();
+    }
+    phase(name);
+    currentPhase = name;
+    wallStart = std::chrono::steady_clock::now();
+    cpuStart = cpuTimeMs();
+    allocationsStart = allocationCount();
+    bytesStart = allocationBytes();
+    if (perfEnabled) {
+        perfStart = perf.read();
+    }
+}
+
+void Stats::endPhase() {
+    if (!active || currentPhase.empty()) {
+        return;
+    }
+    PerfSample perfEnd;
+    if (perfEnabled) {
+        perfEnd = perf.read();
+    }
+    uint64_t allocationsEnd = allocationCount();
+    uint64_t bytesEnd = allocationBytes();
+    PhaseStats& current = phase(currentPhase);
+    if (perfEnabled) {
+        current.counters += perfEnd - perfStart;
+    }
+    current.wallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    current.cpuMs += cpuTimeMs() - cpuStart;
+    current.allocations += allocationsEnd - allocationsStart;
+    current.bytes += bytesEnd - bytesStart;
+    currentPhase.clear();
+}
+
+void Stats::addCount(const std::string& name, uint64_t value) {
+    if (!active) {
+        return;
+    }
+    for (auto& counter : counters) {
+        if (counter.name == name) {
+            counter.value += value;
+            return;
+        }
+    }
+    counters.push_back({name, value});
+}
+
+void Stats::addFunction(const std::string& name, const PerfSample& sample) {
+    for (auto& function : functions) {
+        if (function.name == name) {
+            function.calls++;
+            function.counters += sample;
+            return;
+        }
+    }
+    functions.push_back(FunctionStats());
+    functions.back().name = name;
+    functions.back().calls = 1;
+    functions.back().counters = sample;
+}
+
+// One row of the hardware counter table; unavailable counters print as n/a
+void Stats::writePerfRow(std::ostream& os, const std::string& name, const PerfSample& sample) const {
+    os << std::left << std::setw(16) << name << std::right;
+    for (int i = 0; i < PerfSample::Count; ++i) {
+        os << std::setw(16);
+        if (perf.available(i)) {
+            os << sample.values[i];
+        } else {
+            os << "n/a";
+        }
+    }
+    os << std::endl;
+}
+
+void Stats::write(std::ostream& os) {
+    // A phase cut short by exit() is still reported
+    endPhase();
+    PhaseStats total;
+    total.name = "total";
+    for (const auto& phase : phases) {
+        total.wallMs += phase.wallMs;
+        total.cpuMs += phase.cpuMs;
+        total.allocations += phase.allocations;
+        total.bytes += phase.bytes;
+        total.counters += phase.counters;
+    }
+    // Counters that could not be opened are reported as null
+    auto perfJson = [this, &os](const PerfSample& sample) {
+        os << ", \"counters\": {";
+        for (int i = 0; i < PerfSample::Count; ++i) {
+            os << (i > 0 ? ", " : "") << "\"" << PerfCounters::name(i) << "\": ";
+            if (perf.available(i)) {
+                os << sample.values[i];
+            } else {
+                os << "null";
+            }
+        }
+        os << "}";
+    };
+
+    if (json) {
+        os << "{\"phases\": [";
+        for (size_t i = 0; i < phases.size(); ++i) {
+            const PhaseStats& phase = phases[i];
+            os << (i > 0 ? ", " : "") << "{\"name\": \"" << phase.name << "\""
+               << ", \"wallMs\": " << phase.wallMs << ", \"cpuMs\": " << phase.cpuMs
+               << ", \"allocations\": " << phase.allocations << ", \"bytes\": " << phase.bytes;
+            if (perfEnabled) {
+                perfJson(phase.counters);
+            }
+            os << "}";
+        }
+        os << "], \"wallMs\": " << total.wallMs << ", \"cpuMs\": " << total.cpuMs
+           << ", \"allocations\": " << total.allocations << ", \"bytes\": " << total.bytes;
+        for (const auto& counter : counters) {
+            os << ", \"" << counter.name << "\": " << counter.value;
+        }
+        if (perfEnabled) {
+            perfJson(total.counters);
+        }
+        if (perfFunctions) {
+            os << ", \"functions\": [";
+            for (size_t i = 0; i < functions.size(); ++i) {
+                os << (i > 0 ? ", " : "") << "{\"name\": \"" << functions[i].name << "\", \"calls\": " << functions[i].calls;
+                perfJson(functions[i].counters);
+                os << "}";
+            }
+            os << "]";
+        }
+        os << ", \"heap\": {\"peakBytes\": " << peakHeapBytes() << ", \"categories\": [";
+        for (int i = 0; i < CategoryCount; ++i) {
+            HeapUsage usage = heapUsage(static_cast<HeapCategory>(i));
+            os << (i > 0 ? ", " : "") << "{\"name\": \"" << heapCategoryName(static_cast<HeapCategory>(i))
+               << "\", \"allocations\": " << usage.allocations << ", \"bytes\": " << usage.bytes
+               << ", \"liveBytes\": " << usage.liveBytes << ", \"peakBytes\": " << usage.peakBytes << "}";
+        }
+        os << "]}, \"peakRssKb\": " << peakRssKb() << "}" << std::endl;
+        return;
+    }
+
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::left << std::setw(10) << "phase" << std::right << std::setw(12) << "wall ms"
+       << std::setw(12) << "cpu ms" << std::setw(12) << "allocs" << std::setw(14) << "bytes" << std::endl;
+    auto row = [&os](const PhaseStats& phase) {
+        os << std::left << std::setw(10) << phase.name << std::right << std::fixed << std::setprecision(3)
+           << std::setw(12) << phase.wallMs << std::setw(12) << phase.cpuMs
+           << std::setw(12) << phase.allocations << std::setw(14) << phase.bytes << std::endl;
+    };
+    for (const auto& phase : phases) {
+        row(phase);
+    }
+    row(total);
+    for (const auto& counter : counters) {
+        os << counter.name << ": " << counter.value << std::endl;
+    }
+    os << "peak RSS: " << peakRssKb() << " KB" << std::endl;
+
+    // Category peaks are reached at different times, so they do not add up to
+    // the overall peak
+    os << std::endl << std::left << std::setw(10) << "heap" << std::right << std::setw(12) << "allocs"
+       << std::setw(14) << "bytes" << std::setw(14) << "live" << std::setw(14) << "peak" << std::endl;
+    for (int i = 0; i < CategoryCount; ++i) {
+        HeapUsage usage = heapUsage(static_cast<HeapCategory>(i));
+        if (usage.allocations == 0) {
+            continue;
+        }
+        os << std::left << std::setw(10) << heapCategoryName(static_cast<HeapCategory>(i)) << std::right
+           << std::setw(12) << usage.allocations << std::setw(14) << usage.bytes
+           << std::setw(14) << usage.liveBytes << std::setw(14) << usage.peakBytes << std::endl;
+    }
+    os << "peak heap: " << peakHeapBytes() << " bytes" << std::endl;
+
+    if (perfEnabled) {
+        os << std::endl << std::left << std::setw(16) << "phase" << std::right;
+        for (int i = 0; i < PerfSample::Count; ++i) {
+            os << std::setw(16) << PerfCounters::name(i);
+        }
+        os << std::endl;
+        for (const auto& phase : phases) {
+            writePerfRow(os, phase.name, phase.counters);
+        }
+        writePerfRow(os, "total", total.counters);
+        if (!perf.anyAvailable()) {
+            os << "hardware counters unavailable (perf_event_open failed)" << std::endl;
+        }
+    }
+    if (perfFunctions && !functions.empty()) {
+        os << std::endl << std::left << std::setw(16) << "function" << std::right;
+        for (int i = 0; i < PerfSample::Count; ++i) {
+            os << std::setw(16) << PerfCounters::name(i);
+        }
+        os << std::setw(10) << "calls" << std::endl;
+        for (const auto& function : functions) {
+            std::ostringstream row;
+            writePerfRow(row, function.name, function.counters);
+            std::string text = row.str();
+            text.pop_back();
+            os << text << std::setw(10) << function.calls << std::endl;
+        }
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
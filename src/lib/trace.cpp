@@ -0,0 +1,98 @@
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+Tracer* tracer = nullptr;
+
+Tracer::~Tracer() {
+    close();
+}
+
+bool Tracer::open(const std::string& path) {
+    file.open(path);
+    if (!file) {
+        return false;
+    }
+    start = std::chrono::steady_clock::now();
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    return true;
+}
+
+void Tracer::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    flush();
+    file << "\n]}" << std::endl;
+    file.close();
+}
+
+TraceEvent& Tracer::record(char phase, const char* category, const std::string& name) {
+    if (used == RingSize) {
+        flush();
+    }
+    TraceEvent& event = ring[used++];
+    event.phase = phase;
+    size_t length = std::min(name.size(), sizeof(event.name) - 1);
+    std::memcpy(event.name, name.data(), length);
+    event.name[length] = '\0';
+    event.category = category;
+    event.timestamp = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    event.line = 0;
+    event.value = -1;
+    return event;
+}
+
+void Tracer::begin(const char* category, const std::string& name, int line) {
+    record('B', category, name).line = line;
+}
+
+void Tracer::end(const char* category) {
+    record('E', category, "");
+}
+
+void Tracer::instant(const char* category, const std::string& name, int64_t value) {
+    record('i', category, name).value = value;
+}
+
+bool Tracer::enterCall() {
+    return ++callDepth <= maxCallDepth;
+}
+
+void Tracer::leaveCall() {
+    --callDepth;
+}
+
+// Formats the buffered events and empties the ring
+void Tracer::flush() {
+    if (!file.is_open()) {
+        used = 0;
+        return;
+    }
+    for (size_t i = 0; i < used; ++i) {
+        const TraceEvent& event = ring[i];
+        file << (firstEvent ? "\n" : ",\n") << "{\"ph\": \"" << event.phase << "\", \"cat\": \"" << event.category
+             << "\", \"ts\": " << event.timestamp << ", \"pid\": 1, \"tid\": 1";
+        if (event.phase != 'E') {
+            file << ", \"name\": \"" << event.name << "\"";
+        }
+        if (event.phase == 'i') {
+            file << ", \"s\": \"t\"";
+        }
+        if (event.line > 0 || event.value >= 0) {
+            file << ", \"args\": {";
+            if (event.line > 0) {
+                file << "\"line\": " << event.line;
+            }
+            if (event.value >= 0) {
+                file << (event.line > 0 ? ", " : "") << "\"value\": " << event.value;
+            }
+            file << "}";
+        }
+        file << "}";
+        firstEvent = false;
+    }
+    used = 0;
+}
@@ -1,298 +1,869 @@
-
-#include "ScryptComponents.h"
-#include <stdexcept>
-#include <cmath>
-
-
-// Value class implementation
-Value::Value() : type(Type::Null) {}
-
-Value::Value(double value) : type(Type::Double), doubleValue(value) {}
-
-Value::Value(bool value) : type(Type::Bool), boolValue(value) {}
-
-Value::Value(Function function)
-    : type(Type::Function) {
-    new (&functionValue) Function(std::move(function));
-}
-
-Value::Value(std::vector<Value> array)
-    : type(Type::Array), arrayValue(std::make_shared<std::vector<Value>>(std::move(array))) {}
-
-
-Value::Value(FunctionPtr func) : type(Type::BuiltinFunction), builtinFunction(func) {}
-
-Value::~Value() {
-    cleanUp();
-}
-
-Value::Value(const Value& other) {
-    copyFrom(other);
-}
-
-Value::Value(Value&& other) noexcept {
-    moveFrom(std::move(other));
-}
-
-Value& Value::operator=(const Value& other) {
-    if (this != &other) {
-        cleanUp();
-        copyFrom(other);
-    }
-    return *this;
-}
-
-Value& Value::operator=(Value&& other) noexcept {
-    if (this != &other) {
-        cleanUp();
-        moveFrom(std::move(other));
-    }
-    return *this;
-}
-
-void Value::cleanUp() {
-    if (type != Type::Null) {
-        switch (type) {
-            case Type::Double:
-            case Type::Bool:
-                break;
-            case Type::Function:
-                functionValue.~Function();
-                break;
-            case Type::Array:
-                arrayValue.reset();
-                break;
-            case Type::BuiltinFunction:
-                builtinFunction.~FunctionPtr();
-                break;
-            case Type::Null:
-                break;
-        }
-        type = Type::Null;
-    }
-}
-
-
-
-
-void Value::copyFrom(const Value& other) {
-    type = other.type;
-    switch (type) {
-        case Type::Double:
-            doubleValue = other.doubleValue;
-            break;
-        case Type::Bool:
-            boolValue = other.boolValue;
-            break;
-        case Type::Function:
-            new (&functionValue) Function(other.functionValue); 
-            break;
-        case Type::Array:
-            new (&arrayValue) std::shared_ptr<std::vector<Value>>(other.arrayValue);
-            break;
-        case Type::Null:
-            break;
-        case Type::BuiltinFunction:
-            new (&builtinFunction) FunctionPtr(other.builtinFunction);
-            break;
-    }
-}
-
-
-Value Value::deepCopy() const {
-    switch (type) {
-        case Type::Double:
-            return Value(doubleValue);
-        case Type::Bool:
-            return Value(boolValue);
-        case Type::Array: {
-            auto copiedArray = std::make_shared<std::vector<Value>>();
-            for (const auto& element : *arrayValue) {
-                copiedArray->push_back(element.deepCopy());
-            }
-            return Value(*copiedArray);
-        }
-        case Type::Null:
-            return Value();
-
-        default:
-            throw std::runtime_error("Unknown or unsupported type for deepCopy");
-    }
-}
-
-void Value::moveFrom(Value&& other) {
-    type = other.type;
-    switch (type) {
-        case Type::Double:
-            doubleValue = other.doubleValue;
-            break;
-        case Type::Bool:
-            boolValue = other.boolValue;
-            break;
-        case Type::Function:
-            new (&functionValue) Function(std::move(other.functionValue)); 
-            break;
-        case Type::Array:
-            new (&arrayValue) std::shared_ptr<std::vector<Value>>(std::move(other.arrayValue));
-            break;
-        case Type::Null:
-            break;
-        case Type::BuiltinFunction:
-            new (&builtinFunction) FunctionPtr(std::move(other.builtinFunction));
-            break;
-    }
-    other.type = Type::Null;
-}
-
-
-
-Value::Type Value::getType() const {
-    return type;
-}
-
-double Value::asDouble() const {
-    if (type != Type::Double) {
-        throw std::runtime_error("Runtime error: invalid operand type.");
-    }
-    return doubleValue;
-}
-
-bool Value::asBool() const {
-    if (type != Type::Bool) {
-        throw std::runtime_error("Runtime error: condition is not a bool.");
-    }
-    return boolValue;
-}
-
-const Value::Function& Value::asFunction() const {
-    if (type != Type::Function) {
-        throw std::runtime_error("Runtime error: not a function.");
-    }
-    return functionValue;
-}
-
-bool Value::equals(const Value& other) const {
-    if (this->type != other.type) return false;
-
-    switch (this->type) {
-        case Type::Null:
-            return true;
-        case Type::Bool:
-            return this->boolValue == other.boolValue;
-        case Type::Double:
-            return this->doubleValue == other.doubleValue;
-        case Type::Array: {
-            const auto& thisArray = this->asArray();
-            const auto& otherArray = other.asArray();
-            if (thisArray.size() != otherArray.size()) {
-                return false;
-            }
-            for (size_t i = 0; i < thisArray.size(); ++i) {
-                if (!thisArray[i].equals(otherArray[i])) {
-                    return false;
-                }
-            }
-            return true;
-        }
-        case Type::BuiltinFunction:
-            return this->builtinFunction.target<Value::FunctionPtr>() == other.builtinFunction.target<Value::FunctionPtr>();
-        default:
-            throw std::runtime_error("Unsupported type in Value::equals");
-    }
-}
-
-
-bool Value::isNull() const {
-    return type == Type::Null;
-}
-
-bool Value::isArray() const {
-    return type == Type::Array;
-}
-
-bool Value::isInteger() const {
-    if (type != Type::Double) {
-        return false;
-    }
-    double intPart;
-    return std::modf(doubleValue, &intPart) == 0.0;
-}
-
-
-std::vector<Value>& Value::asArray() {
-    if (type != Type::Array) {
-        throw std::runtime_error("Runtime error: not an array.");
-    }
-    return *arrayValue;
-}
-
-const std::vector<Value>& Value::asArray() const {
-    if (type != Type::Array) {
-        throw std::runtime_error("Runtime error: not an array.");
-    }
-    return *arrayValue;
-}
-
-void Scope::setVariable(const std::string& name, const Value& value) {
-    if (parentScope && parentScope->hasVariable(name)) {
-        parentScope->setVariable(name, value);
-    } else {
-        variables[name] = value;
-    }
-}
-
-// Get a variable from this scope or parent scopes
-Value* Scope::getVariable(const std::string& name) {
-    auto it = variables.find(name);
-    if (it != variables.end()) {
-        return &it->second;
-    } else if (parentScope) {
-        return parentScope->getVariable(name);
-    }
-    return nullptr; 
-}
-
-bool Scope::hasVariable(const std::string& name) {
-    if (variables.count(name) > 0) {
-        return true;
-    } else if (parentScope) {
-        return parentScope->hasVariable(name);
-    }
-    return false;
-}
-
-const std::unordered_map<std::string, Value>& Scope::getVariables() const{
-        return variables;
-    }
-
-std::shared_ptr<Scope> Scope::getParent() const { return parentScope; }
-
-std::shared_ptr<Scope> Scope::copyScope() const {
-    auto newScope = std::make_shared<Scope>(parentScope);
-    for (const auto& var : variables) {
-        newScope->variables[var.first] = var.second;
-    }
-    return newScope;
-}
-
-std::shared_ptr<Scope> Scope::deepCopy() const {
-    auto copiedScope = std::make_shared<Scope>(nullptr);
-    for (const auto& variable : this->variables) {
-        const std::string& name = variable.first;
-        const Value& value = variable.second;
-        copiedScope->variables[name] = value;
-    }
-
-    if (this->parentScope) {
-        copiedScope->parentScope = this->parentScope->deepCopy();
-    }
-
-    return copiedScope;
-}
-
-// ReturnException implementations
-ReturnException::ReturnException(Value returnValue) : returnValue(std::move(returnValue)) {}
-
-const Value& ReturnException::getValue() const {
-    return returnValue;
+
+#include "ScryptComponents.h"
+#include "ArrayData.h"
+#include "MatrixData.h"
+#include "RecordData.h"
+#include "VectorData.h"
+#include "RunArena.h"
+#include "ValueMap.h"
+#include "Stats.h"
+#include <stdexcept>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+// Value class implementation
+Value::Value() : type(Type::Null) {}
+
+Value::Value(double value) : type(Type::Double), doubleValue(value) {}
+
+Value::Value(bool value) : type(Type::Bool), boolValue(value) {}
+
+Value::Value(Function function)
+    : type(Type::Function) {
+    new (&functionValue) Function(std::move(function));
+}
+
+// Array and map holders, taken from the run arena while a run is in progress
+template <typename T, typename... Args>
+static std::shared_ptr<T> makeHolder(Args&&... args) {
+    if (runArena) {
+        return std::allocate_shared<T>(RunAllocator<T>(runArena), std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+Value::Value(std::vector<Value> array) : type(Type::Array) {
+    HeapCategoryScope heap(HeapCategory::Values);
+    new (&arrayValue) std::shared_ptr<ArrayData>(makeHolder<ArrayData>(std::move(array)));
+}
+
+Value::Value(ValueMap map) : type(Type::Map) {
+    HeapCategoryScope heap(HeapCategory::Values);
+    new (&mapValue) std::shared_ptr<ValueMap>(makeHolder<ValueMap>(std::move(map)));
+}
+
+Value::Value(StringPtr string) : type(Type::String) {
+    new (&stringValue) StringPtr(std::move(string));
+}
+
+Value::Value(MatrixData matrix) : type(Type::Matrix) {
+    HeapCategoryScope heap(HeapCategory::Values);
+    new (&matrixValue) std::shared_ptr<MatrixData>(makeHolder<MatrixData>(std::move(matrix)));
+}
+
+Value::Value(RecordData record) : type(Type::Record) {
+    HeapCategoryScope heap(HeapCategory::Values);
+    new (&recordValue) std::shared_ptr<RecordData>(makeHolder<RecordData>(std::move(record)));
+}
+
+Value::Value(VectorData vector) : type(Type::Vector) {
+    HeapCategoryScope heap(HeapCategory::Values);
+    new (&vectorValue) std::shared_ptr<const VectorData>(makeHolder<VectorData>(std::move(vector)));
+}
+
+Value::Value(FunctionPtr func) : type(Type::BuiltinFunction) {
+    HeapCategoryScope heap(HeapCategory::Values);
+    new (&builtinFunction) FunctionPtr(func);
+}
+
+Value::~Value() {
+    cleanUp();
+}
+
+Value::Value(const Value& other) {
+    copyFrom(other);
+}
+
+Value::Value(Value&& other) noexcept {
+    moveFrom(std::move(other));
+}
+
+Value& Value::operator=(const Value& other) {
+    if (this != &other) {
+        cleanUp();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+Value& Value::operator=(Value&& other) noexcept {
+    if (this != &other) {
+        cleanUp();
+        moveFrom(std::move(other));
+    }
+    return *this;
+}
+
+void Value::cleanUp() {
+    if (type != Type::Null) {
+        switch (type) {
+            case Type::Double:
+            case Type::Bool:
+                break;
+            case Type::Function:
+                functionValue.~Function();
+                break;
+            case Type::Array:
+                arrayValue.reset();
+                break;
+            case Type::BuiltinFunction:
+                builtinFunction.~FunctionPtr();
+                break;
+            case Type::Map:
+                mapValue.~shared_ptr();
+                break;
+            case Type::String:
+                stringValue.~StringPtr();
+                break;
+            case Type::Matrix:
+                matrixValue.~shared_ptr();
+                break;
+            case Type::Record:
+                recordValue.~shared_ptr();
+                break;
+            case Type::Vector:
+                vectorValue.~shared_ptr();
+                break;
+            case Type::Null:
+                break;
+        }
+        type = Type::Null;
+    }
+}
+
+
+
+
+void Value::copyFrom(const Value& other) {
+    type = other.type;
+    switch (type) {
+        case Type::Double:
+            doubleValue = other.doubleValue;
+            break;
+        case Type::Bool:
+            boolValue = other.boolValue;
+            break;
+        case Type::Function:
+            new (&functionValue) Function(other.functionValue); 
+            break;
+        case Type::Array:
+            new (&arrayValue) std::shared_ptr<ArrayData>(other.arrayValue);
+            break;
+        case Type::Null:
+            break;
+        case Type::BuiltinFunction:
+            new (&builtinFunction) FunctionPtr(other.builtinFunction);
+            break;
+        case Type::Map:
+            new (&mapValue) std::shared_ptr<ValueMap>(other.mapValue);
+            break;
+        case Type::String:
+            new (&stringValue) StringPtr(other.stringValue);
+            break;
+        case Type::Matrix:
+            new (&matrixValue) std::shared_ptr<MatrixData>(other.matrixValue);
+            break;
+        case Type::Record:
+            new (&recordValue) std::shared_ptr<RecordData>(other.recordValue);
+            break;
+        case Type::Vector:
+            new (&vectorValue) std::shared_ptr<const VectorData>(other.vectorValue);
+            break;
+    }
+}
+
+
+Value Value::deepCopy() const {
+    switch (type) {
+        case Type::Double:
+            return Value(doubleValue);
+        case Type::Bool:
+            return Value(boolValue);
+        case Type::Array: {
+            HeapCategoryScope heap(HeapCategory::Arrays);
+            std::vector<Value> copiedArray;
+            copiedArray.reserve(arrayValue->size());
+            for (const auto& element : asArray()) {
+                copiedArray.push_back(element.deepCopy());
+            }
+            return Value(std::move(copiedArray));
+        }
+        case Type::Map: {
+            HeapCategoryScope heap(HeapCategory::Arrays);
+            ValueMap copiedMap;
+            mapValue->forEach([&copiedMap](const Value& key, const Value& value) {
+                copiedMap[key] = value.deepCopy();
+            });
+            return Value(std::move(copiedMap));
+        }
+        case Type::String:
+            return *this;   // strings are immutable
+        case Type::Matrix:
+            return Value(MatrixData(*matrixValue));
+        case Type::Record: {
+            HeapCategoryScope heap(HeapCategory::Arrays);
+            std::vector<Value> copiedSlots;
+            copiedSlots.reserve(recordValue->size());
+            for (size_t i = 0; i < recordValue->size(); ++i) {
+                copiedSlots.push_back(recordValue->slot(i).deepCopy());
+            }
+            return Value(RecordData(recordValue->layout(), std::move(copiedSlots)));
+        }
+        case Type::Vector:
+            return *this;   // vectors are immutable
+        case Type::Null:
+            return Value();
+
+        default:
+            throw std::runtime_error("Unknown or unsupported type for deepCopy");
+    }
+}
+
+void Value::moveFrom(Value&& other) {
+    type = other.type;
+    switch (type) {
+        case Type::Double:
+            doubleValue = other.doubleValue;
+            break;
+        case Type::Bool:
+            boolValue = other.boolValue;
+            break;
+        case Type::Function:
+            new (&functionValue) Function(std::move(other.functionValue)); 
+            break;
+        case Type::Array:
+            new (&arrayValue) std::shared_ptr<ArrayData>(std::move(other.arrayValue));
+            break;
+        case Type::Null:
+            break;
+        case Type::BuiltinFunction:
+            new (&builtinFunction) FunctionPtr(std::move(other.builtinFunction));
+            break;
+        case Type::Map:
+            new (&mapValue) std::shared_ptr<ValueMap>(std::move(other.mapValue));
+            break;
+        case Type::String:
+            new (&stringValue) StringPtr(std::move(other.stringValue));
+            break;
+        case Type::Matrix:
+            new (&matrixValue) std::shared_ptr<MatrixData>(std::move(other.matrixValue));
+            break;
+        case Type::Record:
+            new (&recordValue) std::shared_ptr<RecordData>(std::move(other.recordValue));
+            break;
+        case Type::Vector:
+            new (&vectorValue) std::shared_ptr<const VectorData>(std::move(other.vectorValue));
+            break;
+    }
+    other.type = Type::Null;
+}
+
+
+
+Value::Type Value::getType() const {
+    return type;
+}
+
+double Value::asDouble() const {
+    if (type != Type::Double) {
+        throw std::runtime_error("Runtime error: invalid operand type.");
+    }
+    return doubleValue;
+}
+
+bool Value::asBool() const {
+    if (type != Type::Bool) {
+        throw std::runtime_error("Runtime error: condition is not a bool.");
+    }
+    return boolValue;
+}
+
+const Value::Function& Value::asFunction() const {
+    if (type != Type::Function) {
+        throw std::runtime_error("Runtime error: not a function.");
+    }
+    return functionValue;
+}
+
+bool Value::equals(const Value& other) const {
+    if (this->type != other.type) return false;
+
+    switch (this->type) {
+        case Type::Null:
+            return true;
+        case Type::Bool:
+            return this->boolValue == other.boolValue;
+        case Type::Double:
+            return this->doubleValue == other.doubleValue;
+        case Type::Array: {
+            const auto& thisArray = this->asArray();
+            const auto& otherArray = other.asArray();
+            if (thisArray.size() != otherArray.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < thisArray.size(); ++i) {
+                if (!thisArray[i].equals(otherArray[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case Type::BuiltinFunction:
+            return this->builtinFunction.target<Value::FunctionPtr>() == other.builtinFunction.target<Value::FunctionPtr>();
+        case Type::Map:
+            return mapValue == other.mapValue || mapValue->equals(*other.mapValue);
+        case Type::String:
+            return stringValue->equals(*other.stringValue);
+        case Type::Matrix:
+            return matrixValue == other.matrixValue || matrixValue->equals(*other.matrixValue);
+        case Type::Record: {
+            if (recordValue == other.recordValue) {
+                return true;
+            }
+            if (recordValue->layout() != other.recordValue->layout()) {
+                return false;
+            }
+            for (size_t i = 0; i < recordValue->size(); ++i) {
+                if (!recordValue->slot(i).equals(other.recordValue->slot(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case Type::Vector:
+            return vectorValue == other.vectorValue || vectorValue->equals(*other.vectorValue);
+        default:
+            throw std::runtime_error("Unsupported type in Value::equals");
+    }
+}
+
+
+bool Value::isNull() const {
+    return type == Type::Null;
+}
+
+bool Value::isArray() const {
+    return type == Type::Array;
+}
+
+bool Value::isInteger() const {
+    if (type != Type::Double) {
+        return false;
+    }
+    double intPart;
+    return std::modf(doubleValue, &intPart) == 0.0;
+}
+
+
+std::vector<Value>& Value::asArray() {
+    if (type != Type::Array) {
+        throw std::runtime_error("Runtime error: not an array.");
+    }
+    return arrayValue->elements();
+}
+
+ArrayElements Value::asArray() const {
+    if (type != Type::Array) {
+        throw std::runtime_error("Runtime error: not an array.");
+    }
+    return ArrayElements(arrayValue->data(), arrayValue->size());
+}
+
+Value Value::sliceArray(size_t begin, size_t end) const {
+    if (type != Type::Array) {
+        throw std::runtime_error("Runtime error: not an array.");
+    }
+    HeapCategoryScope heap(HeapCategory::Values);
+    if (begin == end) {
+        return Value(std::vector<Value>());
+    }
+    size_t offset = begin;
+    std::shared_ptr<ArrayData> source = arrayValue->viewSource(arrayValue, offset);
+    Value slice;
+    slice.type = Type::Array;
+    new (&slice.arrayValue) std::shared_ptr<ArrayData>(makeHolder<ArrayData>(std::move(source), offset, end - begin));
+    return slice;
+}
+
+bool Value::isMap() const {
+    return type == Type::Map;
+}
+
+ValueMap& Value::asMap() {
+    if (type != Type::Map) {
+        throw std::runtime_error("Runtime error: not a map.");
+    }
+    return *mapValue;
+}
+
+const ValueMap& Value::asMap() const {
+    if (type != Type::Map) {
+        throw std::runtime_error("Runtime error: not a map.");
+    }
+    return *mapValue;
+}
+
+bool Value::isString() const {
+    return type == Type::String;
+}
+
+const StringPtr& Value::asString() const {
+    if (type != Type::String) {
+        throw std::runtime_error("Runtime error: not a string.");
+    }
+    return stringValue;
+}
+
+bool Value::isMatrix() const {
+    return type == Type::Matrix;
+}
+
+MatrixData& Value::asMatrix() {
+    if (type != Type::Matrix) {
+        throw std::runtime_error("Runtime error: not a matrix.");
+    }
+    return *matrixValue;
+}
+
+const MatrixData& Value::asMatrix() const {
+    if (type != Type::Matrix) {
+        throw std::runtime_error("Runtime error: not a matrix.");
+    }
+    return *matrixValue;
+}
+
+bool Value::isRecord() const {
+    return type == Type::Record;
+}
+
+RecordData& Value::asRecord() {
+    if (type != Type::Record) {
+        throw std::runtime_error("Runtime error: not a record.");
+    }
+    return *recordValue;
+}
+
+const RecordData& Value::asRecord() const {
+    if (type != Type::Record) {
+        throw std::runtime_error("Runtime error: not a record.");
+    }
+    return *recordValue;
+}
+
+bool Value::isVector() const {
+    return type == Type::Vector;
+}
+
+const VectorData& Value::asVector() const {
+    if (type != Type::Vector) {
+        throw std::runtime_error("Runtime error: not a vector.");
+    }
+    return *vectorValue;
+}
+
+Value Value::executeFunction(std::vector<Value>& args) const {
+    if (type != Type::BuiltinFunction) {
+        throw std::runtime_error("Runtime error: not a function.");
+    }
+    return builtinFunction(args);
+}
+
+namespace {
+
+// Interned strings by text. Entries view the text of their string and are
+// removed by its destructor, so the table never keeps a string alive. It is
+// never destroyed, since strings held by static objects may outlive it.
+struct InternTable {
+    std::mutex mutex;
+    std::unordered_map<std::string_view, const StringData*> strings;
+};
+
+InternTable& internTable() {
+    static InternTable* table = new InternTable;
+    return *table;
+}
+
+}
+
+StringData::StringData(std::string text, bool interned)
+    : flat(std::move(text)), length(flat.size()), interned(interned) {}
+
+StringData::StringData(StringPtr left, StringPtr right)
+    : left(std::move(left)), right(std::move(right)), interned(false) {
+    length = this->left->size() + this->right->size();
+}
+
+StringData::~StringData() {
+    if (interned) {
+        InternTable& table = internTable();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto found = table.strings.find(flat);
+        if (found != table.strings.end() && found->second == this) {
+            table.strings.erase(found);
+        }
+    }
+    release(left);
+    release(right);
+}
+
+// Drops one reference to a rope node without recursing: a node released for
+// the last time hands its children to the loop instead of destroying them
+// itself, so ropes built by long concatenation loops cannot overflow the stack
+void StringData::release(StringPtr& node) {
+    if (!node || node.use_count() > 1 || !node->left) {
+        node.reset();
+        return;
+    }
+    std::vector<StringPtr> pending;
+    pending.push_back(std::move(node));
+    while (!pending.empty()) {
+        StringPtr current = std::move(pending.back());
+        pending.pop_back();
+        if (current && current.use_count() == 1 && current->left) {
+            pending.push_back(std::move(current->left));
+            pending.push_back(std::move(current->right));
+        }
+    }
+}
+
+StringPtr StringData::intern(const std::string& text) {
+    InternTable& table = internTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto found = table.strings.find(text);
+    if (found != table.strings.end()) {
+        if (StringPtr existing = found->second->weak_from_this().lock()) {
+            return existing;
+        }
+        // The old string is being destroyed on another thread
+        table.strings.erase(found);
+    }
+    HeapCategoryScope heap(HeapCategory::Strings);
+    std::shared_ptr<const StringData> created(new StringData(text, true));
+    table.strings.emplace(created->flat, created.get());
+    return created;
+}
+
+StringPtr StringData::make(std::string text) {
+    if (text.size() <= InternLength) {
+        return intern(text);
+    }
+    HeapCategoryScope heap(HeapCategory::Strings);
+    return StringPtr(new StringData(std::move(text), false));
+}
+
+StringPtr StringData::concat(const StringPtr& left, const StringPtr& right) {
+    if (left->size() == 0) {
+        return right;
+    }
+    if (right->size() == 0) {
+        return left;
+    }
+    if (left->size() + right->size() <= InternLength) {
+        return intern(left->text() + right->text());
+    }
+    // Appending a short piece to a rope that ends in a short leaf merges the
+    // two, so appending one character at a time builds leaves of up to
+    // LeafLength characters rather than a node per character
+    if (left->left && !left->right->left && left->right->size() + right->size() <= LeafLength) {
+        StringPtr leaf = make(left->right->text() + right->text());
+        HeapCategoryScope heap(HeapCategory::Strings);
+        return StringPtr(new StringData(left->left, std::move(leaf)));
+    }
+    HeapCategoryScope heap(HeapCategory::Strings);
+    return StringPtr(new StringData(left, right));
+}
+
+// Copies the leaves of the rope into flat, left to right, with an explicit
+// stack instead of recursion, and drops the children
+void StringData::flatten() const {
+    HeapCategoryScope heap(HeapCategory::Strings);
+    std::string result;
+    result.reserve(length);
+    std::vector<const StringData*> pending{this};
+    while (!pending.empty()) {
+        const StringData* node = pending.back();
+        pending.pop_back();
+        if (node->left) {
+            pending.push_back(node->right.get());
+            pending.push_back(node->left.get());
+        } else {
+            result += node->flat;
+        }
+    }
+    flat = std::move(result);
+    release(left);
+    release(right);
+}
+
+size_t StringData::hash() const {
+    if (!hashed) {
+        cachedHash = std::hash<std::string_view>()(text());
+        hashed = true;
+    }
+    return cachedHash;
+}
+
+bool StringData::equals(const StringData& other) const {
+    if (this == &other) {
+        return true;
+    }
+    // Each interned text has a single string
+    if ((interned && other.interned) || length != other.length) {
+        return false;
+    }
+    return text() == other.text();
+}
+
+void Scope::setVariable(const std::string& name, const Value& value) {
+    setVariable(intern(name), value);
+}
+
+void Scope::setVariable(Symbol name, const Value& value) {
+    HeapCategoryScope heap(HeapCategory::Scopes);
+    assignmentTarget(name) = value;
+}
+
+void Scope::setVariable(Symbol name, Value&& value) {
+    HeapCategoryScope heap(HeapCategory::Scopes);
+    assignmentTarget(name) = std::move(value);
+}
+
+// The variable an assignment to name writes: the one in the outermost
+// enclosing scope that already has it, or a new one here when none does. One
+// walk up the chain finds that scope; asking each parent in turn whether its
+// own chain has the name made deep chains quadratic.
+Value& Scope::assignmentTarget(Symbol name) {
+    Value* target = nullptr;
+    for (Scope* scope = parentScope.get(); scope; scope = scope->parentScope.get()) {
+        if (Value* found = scope->variables.find(name)) {
+            target = found;
+        }
+    }
+    return target ? *target : variables[name];
+}
+
+// Get a variable from this scope or parent scopes
+Value* Scope::getVariable(const std::string& name) {
+    return getVariable(intern(name));
+}
+
+Value* Scope::getVariable(Symbol name) {
+    for (Scope* scope = this; scope; scope = scope->parentScope.get()) {
+        if (Value* found = scope->variables.find(name)) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+bool Scope::hasVariable(const std::string& name) {
+    return hasVariable(intern(name));
+}
+
+bool Scope::hasVariable(Symbol name) {
+    return getVariable(name) != nullptr;
+}
+
+const SymbolMap<Value>& Scope::getVariables() const{
+        return variables;
+    }
+
+namespace {
+
+// Free lists of scope blocks, one per block size. allocate_shared puts the
+// Scope and its reference counts in one block, so in practice there is a
+// single size. Each list keeps at most MaxFreeBlocks blocks.
+class ScopePool {
+public:
+    static const size_t MaxFreeBlocks = 4096;
+
+    ~ScopePool() {
+        trim();
+        alive = false;
+    }
+
+    void* allocate(size_t size) {
+        for (FreeList& list : lists) {
+            if (list.size == size && list.head) {
+                FreeBlock* block = list.head;
+                list.head = block->next;
+                list.length--;
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void release(void* pointer, size_t size) {
+        FreeList* list = nullptr;
+        for (FreeList& candidate : lists) {
+            if (candidate.size == size) {
+                list = &candidate;
+                break;
+            }
+        }
+        if (!list) {
+            lists.push_back({size, nullptr, 0});
+            list = &lists.back();
+        }
+        if (list->length >= MaxFreeBlocks) {
+            ::operator delete(pointer);
+            return;
+        }
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->next = list->head;
+        list->head = block;
+        list->length++;
+    }
+
+    void trim() {
+        for (FreeList& list : lists) {
+            while (list.head) {
+                FreeBlock* block = list.head;
+                list.head = block->next;
+                ::operator delete(block);
+            }
+            list.length = 0;
+        }
+    }
+
+    // Cleared when the thread's pool is destroyed; scopes released after that,
+    // such as those held by static objects, go straight back to the heap
+    static thread_local bool alive;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+    struct FreeList {
+        size_t size;
+        FreeBlock* head;
+        size_t length;
+    };
+    std::vector<FreeList> lists;
+};
+
+thread_local bool ScopePool::alive = true;
+thread_local ScopePool scopePool;
+
+template <typename T>
+struct ScopeAllocator {
+    using value_type = T;
+
+    ScopeAllocator() = default;
+    template <typename U>
+    ScopeAllocator(const ScopeAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (!ScopePool::alive) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(scopePool.allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        if (!ScopePool::alive) {
+            ::operator delete(pointer);
+            return;
+        }
+        scopePool.release(pointer, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const ScopeAllocator<T>&, const ScopeAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const ScopeAllocator<T>&, const ScopeAllocator<U>&) { return false; }
+
+}
+
+// Most recently created live scope of the run in progress on this thread
+static thread_local Scope* lastRunScope = nullptr;
+
+std::shared_ptr<Scope> Scope::create(std::shared_ptr<Scope> parent) {
+    auto scope = std::allocate_shared<Scope>(ScopeAllocator<Scope>(), std::move(parent));
+    if (runArena) {
+        scope->inRun = true;
+        scope->previousInRun = lastRunScope;
+        if (lastRunScope) {
+            lastRunScope->nextInRun = scope.get();
+        }
+        lastRunScope = scope.get();
+    }
+    return scope;
+}
+
+Scope::~Scope() {
+    if (inRun) {
+        unlinkFromRun();
+    }
+}
+
+void Scope::unlinkFromRun() {
+    if (previousInRun) {
+        previousInRun->nextInRun = nextInRun;
+    }
+    if (nextInRun) {
+        nextInRun->previousInRun = previousInRun;
+    } else {
+        lastRunScope = previousInRun;
+    }
+    inRun = false;
+    previousInRun = nullptr;
+    nextInRun = nullptr;
+}
+
+void Scope::releaseRunScopes() {
+    while (Scope* scope = lastRunScope) {
+        scope->unlinkFromRun();
+        // The values are moved out before they are destroyed, since dropping
+        // them may destroy this scope and others
+        std::vector<Value> released;
+        released.reserve(scope->variables.size());
+        scope->variables.forEach([&released](Symbol, Value& value) { released.push_back(std::move(value)); });
+        std::shared_ptr<Scope> parent = std::move(scope->parentScope);
+    }
+}
+
+void Scope::trimPool() {
+    if (ScopePool::alive) {
+        scopePool.trim();
+    }
+}
+
+std::shared_ptr<Scope> Scope::getParent() const { return parentScope; }
+
+std::shared_ptr<Scope> Scope::copyScope() const {
+    auto newScope = Scope::create(parentScope);
+    newScope->variables = variables;
+    return newScope;
+}
+
+std::shared_ptr<Scope> Scope::deepCopy() const {
+    auto copiedScope = Scope::create();
+    copiedScope->variables = this->variables;
+
+    if (this->parentScope) {
+        copiedScope->parentScope = this->parentScope->deepCopy();
+    }
+
+    return copiedScope;
+}
+
+// ReturnException implementations
+ReturnException::ReturnException(Value returnValue) : returnValue(std::move(returnValue)) {}
+
+Value& ReturnException::getValue() {
+    return returnValue;
+}
+
+const Value& ReturnException::getValue() const {
+    return returnValue;
 }
\ No newline at end of file
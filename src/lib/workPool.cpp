@@ -0,0 +1,131 @@
+#include "WorkPool.h"
+#include <algorithm>
+
+static unsigned defaultThreads = 0;
+
+// Queue of the pool thread running on this thread; 0 for other threads
+static thread_local size_t homeQueue = 0;
+
+WorkPool& WorkPool::shared() {
+    static WorkPool pool(defaultThreads ? defaultThreads : std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+void WorkPool::setDefaultThreads(unsigned threads) {
+    defaultThreads = threads;
+}
+
+WorkPool::WorkPool(unsigned threads) {
+    unsigned count = std::max(1u, threads);
+    for (unsigned i = 0; i < count; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 1; i < count; ++i) {
+        workers.emplace_back(&WorkPool::workerLoop, this, i);
+    }
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.body = &body;
+    job.remaining = count;
+    for (size_t i = 0; i < count; ++i) {
+        Queue& queue = *queues[i % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({&job, i});
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedTasks += count;
+    }
+    wake.notify_all();
+
+    // Tasks of this job may still be running elsewhere once the queues are
+    // empty; the job lives on this stack, so wait for them
+    size_t home = homeQueue;
+    while (job.remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(home)) {
+            std::this_thread::yield();
+        }
+    }
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+void WorkPool::workerLoop(size_t home) {
+    homeQueue = home;
+    while (true) {
+        if (runOne(home)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+// Runs one task from the back of queue home or, failing that, from the front
+// of another queue. Returns false when every queue is empty.
+bool WorkPool::runOne(size_t home) {
+    for (size_t offset = 0; offset < queues.size(); ++offset) {
+        Queue& queue = *queues[(home + offset) % queues.size()];
+        Task task{};
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.head == queue.tasks.size()) {
+                continue;
+            }
+            if (offset == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            } else {
+                task = queue.tasks[queue.head++];
+            }
+            if (queue.head == queue.tasks.size()) {
+                queue.tasks.clear();
+                queue.head = 0;
+            }
+        }
+        queuedTasks--;
+        run(task);
+        return true;
+    }
+    return false;
+}
+
+void WorkPool::run(const Task& task) {
+    Job& job = *task.job;
+    try {
+        (*job.body)(task.index);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job.errorMutex);
+        if (!job.error) {
+            job.error = std::current_exception();
+        }
+    }
+    job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+}